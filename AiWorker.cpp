@@ -0,0 +1,86 @@
+#include "AiWorker.h"
+#include "FrameProfiler.h"
+
+template <class V>
+BasicAiWorker<V>::~BasicAiWorker() {
+    {
+        std::lock_guard<std::mutex> lk(m);
+        quit = true;
+        stop = true;
+    }
+    wake.notify_one();
+    if (thread.joinable()) thread.join();
+}
+
+template <class V>
+void BasicAiWorker<V>::Post(const Policy& policy, const State& s, const MoveList& legal, const CounterRng& rng) {
+    pending = true;
+    std::unique_lock<std::mutex> lk(m);
+    stop = true;                        // whatever runs now is stale
+    ++posted;
+    if (policy.kind != POLICY_SEARCH) {
+        queued = false;
+        answerRng = rng;
+        PROFILE_SCOPE("AiMove");
+        answer = PickPolicyMove(policy, s, legal, answerRng);
+        answered = posted;
+        return;
+    }
+    job = { policy, s, legal, rng };
+    queued = true;
+    lk.unlock();
+    if (!thread.joinable()) thread = std::thread(&BasicAiWorker<V>::Run, this);
+    wake.notify_one();
+}
+
+template <class V>
+bool BasicAiWorker<V>::Poll(Move& move, CounterRng& rng) {
+    if (!pending) return false;
+    std::unique_lock<std::mutex> lk(m, std::try_to_lock);
+    if (!lk.owns_lock() || answered != posted) return false;
+    move = answer;
+    rng = answerRng;
+    pending = false;
+    return true;
+}
+
+template <class V>
+void BasicAiWorker<V>::Cancel() {
+    pending = false;
+    std::lock_guard<std::mutex> lk(m);
+    stop = true;
+    queued = false;
+    ++posted;                           // no answer will match
+}
+
+template <class V>
+void BasicAiWorker<V>::Run() {
+    Job mine;
+    for (;;) {
+        uint64_t ticket;
+        {
+            std::unique_lock<std::mutex> lk(m);
+            wake.wait(lk, [&] { return queued || quit; });
+            if (quit) return;
+            mine = job;
+            ticket = posted;
+            queued = false;
+            stop = false;
+        }
+        mine.policy.search.cancel = &stop;
+        Move mv;
+        {
+            PROFILE_SCOPE("AiMove");
+            mv = PickPolicyMove(mine.policy, mine.state, mine.legal, mine.rng);
+        }
+        std::lock_guard<std::mutex> lk(m);
+        if (ticket != posted) continue;         // cancelled or superseded meanwhile
+        answer = mv;
+        answerRng = mine.rng;
+        answered = ticket;
+    }
+}
+
+template class BasicAiWorker<ClassicBoard>;
+template class BasicAiWorker<DuelBoard>;
+template class BasicAiWorker<SixBoard>;
@@ -0,0 +1,63 @@
+#pragma once
+// Background thinking for the computer seats of the GUI.
+//
+// Post() hands the worker a copy of the position, the legal moves and the
+// AI's random stream; Poll() collects the answer once it is in. Neither
+// waits on the worker, so the frame loop keeps its 60 FPS while a search
+// runs. Posting again or calling Cancel() stops the search in progress and
+// drops its answer. The policy's own time budget bounds how long a search
+// thinks.
+//
+// Policies that take microseconds (random, first, greedy) are answered
+// inside Post(): a trip through the thread would cost more than the pick.
+// The answer carries the advanced random stream, so a game plays out the
+// same as with PickPolicyMove() called inline. Nothing here allocates
+// after the thread has started.
+#include "LudoAi.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+template <class V>
+class BasicAiWorker {
+public:
+    using State = BasicGameState<V>;
+
+    BasicAiWorker() = default;
+    ~BasicAiWorker();                   // cancels and joins
+    BasicAiWorker(const BasicAiWorker&) = delete;
+    BasicAiWorker& operator=(const BasicAiWorker&) = delete;
+
+    void Post(const Policy& policy, const State& s, const MoveList& legal, const CounterRng& rng);
+    // True once the answer to the last Post() is in; `rng` becomes the
+    // stream as the pick left it. Never blocks.
+    bool Poll(Move& move, CounterRng& rng);
+    void Cancel();
+    bool Pending() const { return pending; }   // posted, not yet collected or cancelled
+
+private:
+    struct Job {
+        Policy policy;
+        State state;
+        MoveList legal;
+        CounterRng rng;
+    };
+
+    void Run();
+
+    std::thread thread;
+    std::mutex m;
+    std::condition_variable wake;
+    Job job;                            // the last Post(), until the worker takes it
+    bool queued = false;
+    bool quit = false;
+    uint64_t posted = 0;                // ticket of the last Post()
+    uint64_t answered = 0;              // ticket `answer` belongs to
+    Move answer{};
+    CounterRng answerRng;
+    std::atomic<bool> stop{ false };    // ends the search in progress (SearchLimits::cancel)
+    bool pending = false;               // main thread only
+};
+
+using AiWorker = BasicAiWorker<ClassicBoard>;
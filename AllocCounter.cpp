@@ -0,0 +1,39 @@
+#include "AllocCounter.h"
+
+#ifdef LUDO_COUNT_ALLOCS
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<uint64_t> allocCount{ 0 };
+
+bool AllocCountingEnabled() { return true; }
+uint64_t AllocCount() { return allocCount.load(std::memory_order_relaxed); }
+
+static void* CountedAlloc(std::size_t n, std::size_t align) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    if (n == 0) n = 1;
+    void* p = align > alignof(std::max_align_t)
+        ? std::aligned_alloc(align, (n + align - 1) / align * align)
+        : std::malloc(n);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(std::size_t n) { return CountedAlloc(n, 0); }
+void* operator new[](std::size_t n) { return CountedAlloc(n, 0); }
+void* operator new(std::size_t n, std::align_val_t a) { return CountedAlloc(n, (std::size_t)a); }
+void* operator new[](std::size_t n, std::align_val_t a) { return CountedAlloc(n, (std::size_t)a); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+#else
+bool AllocCountingEnabled() { return false; }
+uint64_t AllocCount() { return 0; }
+#endif
@@ -0,0 +1,14 @@
+#pragma once
+// Debug heap instrumentation. Build with -DLUDO_COUNT_ALLOCS to replace the
+// global operator new/delete with counting versions; otherwise every
+// query returns 0 and nothing is replaced.
+#include <cstdint>
+
+bool     AllocCountingEnabled();
+uint64_t AllocCount();          // operator new calls so far, all threads
+
+// Counts allocations made while it is alive.
+struct AllocScope {
+    uint64_t start = AllocCount();
+    uint64_t Count() const { return AllocCount() - start; }
+};
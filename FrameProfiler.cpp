@@ -0,0 +1,121 @@
+#include "FrameProfiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+static const uint64_t RING_MASK = PROFILE_RING_SIZE - 1;
+
+static ProfileRing ring;
+static const auto clockOrigin = std::chrono::steady_clock::now();
+static std::atomic<uint32_t> nextThread{ 0 };
+
+uint64_t ProfileNow() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - clockOrigin).count();
+}
+
+ProfileRing& Profiler() { return ring; }
+
+static uint32_t ThreadId() {
+    thread_local uint32_t id = nextThread.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+// =================== RING =======================
+void ProfileRing::Push(const char* name, uint64_t startNs, uint64_t endNs) {
+    uint64_t i = head.fetch_add(1, std::memory_order_relaxed);
+    Slot& s = slots[i & RING_MASK];
+    uint64_t dur = std::min<uint64_t>(endNs - startNs, UINT32_MAX);
+    s.seq.store(2 * i + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    s.name.store(name, std::memory_order_relaxed);
+    s.startNs.store(startNs, std::memory_order_relaxed);
+    s.durThread.store(dur << 32 | ThreadId(), std::memory_order_relaxed);
+    s.seq.store(2 * (i + 1), std::memory_order_release);
+}
+
+void ProfileRing::Snapshot(std::vector<ProfileEvent>& out, size_t max, uint64_t sinceNs) const {
+    out.clear();
+    uint64_t end = head.load(std::memory_order_acquire);
+    uint64_t n = std::min<uint64_t>({ end, (uint64_t)PROFILE_RING_SIZE, (uint64_t)max });
+    // Newest first, then reversed; an event that is not (or no longer) the
+    // one at index i is skipped.
+    for (uint64_t i = end; i-- > end - n;) {
+        const Slot& s = slots[i & RING_MASK];
+        uint64_t want = 2 * (i + 1);
+        if (s.seq.load(std::memory_order_acquire) != want) continue;
+        ProfileEvent e;
+        e.name = s.name.load(std::memory_order_relaxed);
+        e.startNs = s.startNs.load(std::memory_order_relaxed);
+        uint64_t dt = s.durThread.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s.seq.load(std::memory_order_relaxed) != want) continue;
+        if (e.startNs < sinceNs) {
+            // Events are pushed when they end, so an older start can still
+            // follow a newer one; only stop once well past the window.
+            if (sinceNs - e.startNs > 1000000000ull) break;
+            continue;
+        }
+        e.durNs = (uint32_t)(dt >> 32);
+        e.thread = (uint32_t)dt;
+        out.push_back(e);
+    }
+    std::reverse(out.begin(), out.end());
+}
+
+// =================== SUMMARY ====================
+ProfileSummary::ProfileSummary(const char* const* names, int count, size_t graphFrames_)
+    : graphFrames(graphFrames_) {
+    for (int i = 0; i < count; ++i) { PhaseStat st; st.name = names[i]; phases.push_back(st); }
+    frameMs.reserve(graphFrames);
+    events.reserve(PROFILE_RING_SIZE);
+    durations.reserve(PROFILE_RING_SIZE);
+}
+
+void ProfileSummary::Update(const ProfileRing& r, uint64_t windowNs) {
+    uint64_t now = ProfileNow();
+    r.Snapshot(events, PROFILE_RING_SIZE, now > windowNs ? now - windowNs : 0);
+    for (size_t k = 0; k < phases.size(); ++k) {
+        PhaseStat& st = phases[k];
+        durations.clear();
+        double sum = 0;
+        for (const ProfileEvent& e : events)
+            if (e.name == st.name || std::strcmp(e.name, st.name) == 0) {
+                float ms = e.durNs * 1e-6f;
+                durations.push_back(ms);
+                sum += ms;
+            }
+        st.calls = (uint32_t)durations.size();
+        if (k == 0) {
+            frames = st.calls;
+            size_t from = durations.size() > graphFrames ? durations.size() - graphFrames : 0;
+            frameMs.assign(durations.begin() + from, durations.end());
+        }
+        if (durations.empty()) { st.avgMs = st.p99Ms = st.maxMs = 0; continue; }
+        st.avgMs = sum / durations.size();
+        size_t at = (durations.size() * 99) / 100;
+        std::nth_element(durations.begin(), durations.begin() + at, durations.end());
+        st.p99Ms = durations[at];
+        st.maxMs = *std::max_element(durations.begin() + at, durations.end());
+    }
+}
+
+// =================== CHROME TRACE ===============
+// Phase names are plain identifiers here, so they are written unescaped.
+long WriteChromeTrace(const ProfileRing& r, const char* path) {
+    std::vector<ProfileEvent> all;
+    all.reserve(PROFILE_RING_SIZE);
+    r.Snapshot(all, PROFILE_RING_SIZE);
+    FILE* f = fopen(path, "wb");
+    if (!f) return -1;
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (size_t i = 0; i < all.size(); ++i) {
+        const ProfileEvent& e = all[i];
+        fprintf(f, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+                e.name, e.thread, e.startNs / 1000.0, e.durNs / 1000.0, i + 1 < all.size() ? "," : "");
+    }
+    fprintf(f, "]}\n");
+    bool ok = fclose(f) == 0;
+    return ok ? (long)all.size() : -1;
+}
@@ -0,0 +1,89 @@
+#pragma once
+// Scoped timing markers for the frame loop.
+//
+// PROFILE_SCOPE("Name") times the rest of the enclosing block and pushes
+// one event into a global lock-free ring that always holds the most recent
+// PROFILE_RING_SIZE events, from any thread. ProfileSummary turns a window
+// of that history into per-phase statistics and frame times for an
+// overlay; WriteChromeTrace dumps it as Chrome trace_event JSON (open in
+// chrome://tracing or ui.perfetto.dev). Names must be string literals or
+// otherwise outlive the ring.
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+static const uint32_t PROFILE_RING_SIZE = 1u << 15;   // events, a power of two
+
+struct ProfileEvent {
+    const char* name;
+    uint64_t startNs;           // since the profiler clock's origin
+    uint32_t durNs;
+    uint32_t thread;            // small id in order of first use, 0 = first thread that recorded
+};
+
+// Multi-producer ring. A writer claims a slot with one fetch_add and
+// publishes it through the slot's sequence number; nobody waits. Readers
+// copy slots and drop any that a writer touched while they were reading.
+class ProfileRing {
+public:
+    void Push(const char* name, uint64_t startNs, uint64_t endNs);
+    // The newest events that started at or after `sinceNs`, at most `max`,
+    // oldest first. `out` is cleared; it allocates only if `max` exceeds its capacity.
+    void Snapshot(std::vector<ProfileEvent>& out, size_t max, uint64_t sinceNs = 0) const;
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq{ 0 };         // 2*(index+1) once published, odd while written
+        std::atomic<const char*> name{ nullptr };
+        std::atomic<uint64_t> startNs{ 0 };
+        std::atomic<uint64_t> durThread{ 0 };   // durNs << 32 | thread
+    };
+    Slot slots[PROFILE_RING_SIZE];
+    std::atomic<uint64_t> head{ 0 };
+};
+
+uint64_t     ProfileNow();      // steady clock, ns
+ProfileRing& Profiler();        // the process-wide ring
+
+struct ProfileScope {
+    const char* name;
+    uint64_t start;
+    explicit ProfileScope(const char* n) : name(n), start(ProfileNow()) {}
+    ~ProfileScope() { Profiler().Push(name, start, ProfileNow()); }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+
+struct PhaseStat {
+    const char* name;
+    uint32_t calls = 0;
+    double   avgMs = 0, p99Ms = 0, maxMs = 0;
+};
+
+// Statistics over a recent window of the ring for a fixed list of phase
+// names (matched by content). phases[0] is taken to be the whole frame:
+// its durations also fill frameMs. All buffers are sized up front, so
+// Update() does not allocate.
+class ProfileSummary {
+public:
+    ProfileSummary(const char* const* names, int count, size_t graphFrames = 120);
+    void Update(const ProfileRing& ring, uint64_t windowNs);
+
+    std::vector<PhaseStat> phases;
+    std::vector<float> frameMs;                 // last graphFrames frames, oldest first
+    uint32_t frames = 0;                        // frames in the window
+
+private:
+    size_t graphFrames;
+    std::vector<ProfileEvent> events;
+    std::vector<float> durations;
+};
+
+// Writes the whole ring as {"traceEvents":[...]} complete ("X") events.
+// Returns the number of events written, or -1 if the file cannot be opened.
+long WriteChromeTrace(const ProfileRing& ring, const char* path);
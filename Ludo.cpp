@@ -1,18 +1,45 @@
 ﻿#include "raylib.h"
+#include "LudoAi.h"
+#include "AiWorker.h"
+#include "LudoOdds.h"
+#include "AllocCounter.h"
+#include "LudoReplay.h"
+#include "LudoSnapshot.h"
+#include "FrameProfiler.h"
+#include "rlgl.h"
 #include <vector>
-#include <map>
 #include <algorithm>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <cmath>
+#include <chrono>
 
 // =================== CONFIG ===================
-static const int BOARD_N = 15;             // 15x15 grid
+static const int BOARD_N = CROSS_N;        // 15x15 grid
 static const int CELL = 44;
 static const int SIDEBAR_W = 300;
 static const int BOARD_W = BOARD_N * CELL;
 static const int SCR_W = BOARD_W + SIDEBAR_W;
 static const int SCR_H = BOARD_W;
+static const char* REPLAY_OUT = "ludo_replay.bin";   // every live game streams here
+static const char* TABLEBASE_FILE = "ludo_race.tb"; // optional, from ludo_tbgen
+static const char* SNAPSHOT_OUT = "ludo_save.bin";  // rewritten every turn; --resume continues from it
+static const int UNDO_TURNS = 256;                  // U/Y history
+static const float SIM_DT = 1.0f / 60.0f;           // fixed game-logic step, independent of the frame rate
+static const int MAX_SIM_STEPS = 8;                 // per frame; a longer stall drops time instead of catching up
+static const float AI_DELAY = 0.6f;                 // normal speed: pause before each AI action
+static const int AI_THINK_MS = 400;                 // normal speed: search budget, spent while the dice roll
+static const char* TRACE_OUT = "ludo_trace.json";   // D: profiler history as Chrome trace JSON
+static const uint64_t PROFILE_WINDOW_NS = 2000000000ull;   // overlay statistics cover the last 2 s
+static const int GRID_MAX = 64;                     // --grid: boards in one window
+static const float GRID_TURN_TIME = 0.3f;           // --grid, normal speed: one turn per board this often
+static const float GRID_HOLD = 2.0f;                // --grid: a finished board shows its result this long
+static const float GRID_SLIDE = 0.15f;              // --grid: the piece just moved slides this long
+static const double GRID_AI_MS = 8.0;               // --grid: turns played per frame stop after this
+static const int GRID_HEADER = 28;                  // --grid: status line above the tiles
+static const int GRID_GAP = 4;                      // --grid: space between tiles
 
 // =================== UTILS ====================
 float LerpF(float a, float b, float t) { return a + (b - a) * t; }
@@ -27,54 +54,102 @@ struct MoveAnim {
     float duration = 0.35f;
 };
 
-struct Piece {
-    int player = 0;           // 0=YELLOW, 1=BLUE, 2=GREEN, 3=RED
-    bool inHome = true;
-    bool inFinal = false;
-    int  outerIdx = -1;
-    int  finalIdx = -1;
-    MoveAnim anim;
-};
-
+// Presentation only; piece positions and turn order live in `game`.
 struct Player {
     Color color = WHITE;
-    std::vector<Piece> pieces;
+    MoveAnim anims[NUM_PIECES];
     bool isAI = false;
-    bool finished = false;
-    int  finishPlace = 0;
+    int arm = 0;                            // arm of the cross this seat plays (LudoBoard.h)
 };
 
+// Per arm of the cross: 0 TL, 1 TR, 2 BL, 3 BR (You)
+static const Color ARM_COLOR[CROSS_ARMS] = { YELLOW, BLUE, GREEN, RED };
+static const char* ARM_NAME[CROSS_ARMS] = { "Yellow", "Blue", "Green", "Red" };
+static const int HUMAN_ARM = 3;
+
 // =================== GLOBALS ==================
 Rectangle boardRect{ 0,0,(float)BOARD_W,(float)BOARD_W };
 std::vector<Vec2i> outerPath;               // loop squares
-std::vector<std::vector<Vec2i>> finalPaths(4);
-int startIndexFor[4] = { 0, 11, 23, 35 };     // per-player entry into loop
+std::vector<std::vector<Vec2i>> finalPaths; // per seat
 int cellFlags[BOARD_N][BOARD_N] = { 0 };      // 0=normal, 2=safe
+int boardLayoutVersion = 0;                 // bumped by BuildBoardAndPaths
 
+// Authoritative rules state. --players picks the board variant at startup
+// (classic 4 seats or the 2-seat duel); only that instantiation is used.
+template <class V> BasicGameState<V> game;
+int numPlayers = NUM_PLAYERS;
 std::vector<Player> players;
-int currentPlayer = 3;                      // YOU (RED)
 int rollResult = 0;
 bool hasRolled = false;
+MoveList legalNow;                          // legal moves for rollResult, computed once per roll
 
 bool diceRollingAnim = false;
 float diceAnimTime = 0.0f;
 float diceAnimDuration = 1.0f;
-int diceFaceDuring = 1;
+int diceFaceDuring = 1;                     // cosmetic only
+int pendingRoll = 0;                        // real result, drawn from diceRng when the roll starts
 
 float globalTime = 0.0f;
 
-int playersFinishedCount = 0;
-int nextFinishPlace = 1;
+// Heap allocations per frame (needs -DLUDO_COUNT_ALLOCS, see AllocCounter.h)
+uint64_t frameAllocs = 0, steadyAllocPeak = 0, frameNo = 0;
+static const uint64_t ALLOC_WARMUP_FRAMES = 120;   // first AI search sizes its tables
+uint64_t gameSeed = 0;                      // dice and AI streams derive from this
+CounterRng diceRng;                         // game dice: (gameSeed, 0) reproduces the game
+CounterRng aiRng;                           // AI tie-breaks
+ReplayFileWriter replayOut;
+
+// Replay mode (--replay FILE): no input or AI, just seeking through a log
+bool replayMode = false;
+std::vector<uint8_t> replayData;
+ReplayGameView replayGame;
+uint32_t replayTurn = 0;
+bool replayAutoplay = false;
+float replayTimer = 0.0f;
+Policy aiPolicy;                            // what the computer seats play
+template <class V> BasicAiWorker<V> aiWorker;   // thinks for them off the frame loop
+template <class V> BasicOddsMeter<V> oddsMeter; // win chances in the sidebar
+RaceTablebase raceTable;                    // mapped at startup when TABLEBASE_FILE exists
+
+// Simulation speed. Normal animates everything; turbo resolves whole AI
+// turns without animation and draws one frame per turboTurnsPerFrame turns;
+// headless (--headless N) never opens a window.
+enum SimSpeed { SPEED_NORMAL, SPEED_TURBO, SPEED_HEADLESS };
+SimSpeed simSpeed = SPEED_NORMAL;
+int turboTurnsPerFrame = 16;
+float simAccum = 0.0f;                      // real time not yet consumed by SIM_DT steps
+float aiTimer = 0.0f;
+bool allAi = false;                         // --all-ai: RED is a computer seat too
+uint64_t gameIndex = 0;                     // dice stream (gameSeed, gameIndex)
+bool resumeGame = false;                    // --resume: start from SNAPSHOT_OUT
+
+// Every turn of a live game is pushed to the history (U/Y) and written to
+// SNAPSHOT_OUT. A take-back rewinds the replay log once play goes on.
+uint32_t turnsPlayed = 0;                   // turns of the current game, passes included
+template <class V> HistoryRing<BasicSnapshot<V>, UNDO_TURNS> history;
+template <class V> BasicSnapshotFile<V> autosave;
+
+// Frame profiler (FrameProfiler.h): the loop phases are always recorded;
+// P shows the overlay, D writes TRACE_OUT.
+enum ProfilePhase { PH_FRAME, PH_INPUT, PH_ANIMS, PH_DICE, PH_AI, PH_BOARD, PH_PIECES, PH_SIDEBAR, PH_PRESENT, PH_COUNT };
+static const char* const PHASE_NAME[PH_COUNT] = {
+    "Frame", "InputTurn", "UpdateAnims", "DiceTick", "AiMove", "DrawBoard", "DrawPieces", "DrawSidebar", "Present" };
+bool profilerOverlay = false;
+ProfileSummary profileView(PHASE_NAME, PH_COUNT);
+long lastTraceEvents = 0;                   // events in the last dump, -1 = write failed
 
 // =================== DRAW HELPERS =============
-void DrawStarOutline(int cx, int cy, float radius, Color color) {
+void DrawStarOutline(int cx, int cy, float radius, Color color, float thick = 1.0f) {
     Vector2 pts[10];
     for (int i = 0; i < 10; ++i) {
         float ang = i * 36 * DEG2RAD - 90 * DEG2RAD;
         float r = (i % 2 == 0) ? radius : radius / 2.5f;
         pts[i] = { cx + r * cosf(ang), cy + r * sinf(ang) };
     }
-    for (int i = 0; i < 10; ++i) DrawLineV(pts[i], pts[(i + 1) % 10], color);
+    for (int i = 0; i < 10; ++i) {
+        if (thick > 1.0f) DrawLineEx(pts[i], pts[(i + 1) % 10], thick, color);
+        else DrawLineV(pts[i], pts[(i + 1) % 10], color);
+    }
 }
 
 void DrawTrophy(int cx, int cy, float size, Color color) {
@@ -104,437 +179,1067 @@ Vector2 CellCenter(int row, int col) {
              boardRect.y + row * CELL + CELL * 0.5f };
 }
 
+template <class V>
 void BuildBoardAndPaths() {
     // Clear flags
     for (int r = 0; r < BOARD_N; ++r) for (int c = 0; c < BOARD_N; ++c) cellFlags[r][c] = 0;
 
-    // --- Loop path (data-driven & consistent with visuals) ---
-    // The loop runs around the central cross. (Total count here = 43 cells.)
+    // --- Loop path, home strips and safe cells: compile-time tables from LudoBoard.h ---
+    const BoardGeometry<V>& g = GEOMETRY<V>;
     outerPath.clear();
-    for (int c = 3; c <= 11; c++) outerPath.push_back({ 1, c });    // across top
-    for (int r = 2; r <= 6; r++) outerPath.push_back({ r, 11 });   // down right
-    for (int c = 10; c >= 6; c--) outerPath.push_back({ 6, c });    // left mid
-    for (int r = 7; r <= 11; r++) outerPath.push_back({ r, 6 });    // down center
-    for (int c = 5; c >= 1; c--) outerPath.push_back({ 11, c });    // left bottom
-    for (int r = 10; r >= 6; r--) outerPath.push_back({ r, 1 });    // up left
-    for (int c = 2; c <= 6; c++) outerPath.push_back({ 6, c });     // right mid
-    for (int r = 5; r >= 2; r--) outerPath.push_back({ r, 6 });     // up center
-
-    // Start indices (entry from each quadrant)
-    startIndexFor[0] = 0;   // Yellow (top-left)
-    startIndexFor[1] = 11;  // Blue   (top-right)
-    startIndexFor[2] = 23;  // Green  (bottom-left)
-    startIndexFor[3] = 35;  // Red    (bottom-right)
-
-    // Safe cells: all starts + central crossing
-    for (int p = 0; p < 4; ++p) { Vec2i s = outerPath[startIndexFor[p]]; cellFlags[s.r][s.c] = 2; }
-    cellFlags[6][6] = 2;
-
-    // Final home paths (6 cells; index 5 is the "home stop")
-    finalPaths[0] = { {5,6},{4,6},{3,6},{2,6},{1,6},{0,6} };       // Yellow up
-    finalPaths[1] = { {6,5},{6,4},{6,3},{6,2},{6,1},{6,0} };       // Blue left
-    finalPaths[2] = { {7,6},{8,6},{9,6},{10,6},{11,6},{12,6} };    // Green down
-    finalPaths[3] = { {6,7},{6,8},{6,9},{6,10},{6,11},{6,12} };    // Red right
+    for (const BoardCell& v : g.loop) outerPath.push_back({ v.r, v.c });
+    finalPaths.assign(V::PLAYERS, {});
+    for (int p = 0; p < V::PLAYERS; ++p)
+        for (const BoardCell& v : g.finalPath[p]) finalPaths[p].push_back({ v.r, v.c });
+    for (int i = 0; i < V::LOOP_LEN; ++i)
+        if (IsSafeSquare<V>(i)) { Vec2i s = outerPath[i]; cellFlags[s.r][s.c] = 2; }
+    boardLayoutVersion++;
+}
+
+void ClearRoll() {
+    hasRolled = false; rollResult = 0; legalNow = MoveList();
+}
+
+// Seat name for the sidebar.
+const char* SeatLabel(int p) {
+    return players[p].arm == HUMAN_ARM ? "You (RED)" : ARM_NAME[players[p].arm];
+}
+
+void SnapAnims() {
+    for (auto& pl : players) for (auto& a : pl.anims) a.active = false;
 }
 
+// =================== SNAPSHOTS ================
+template <class V>
+BasicSnapshot<V> TakeSnapshot() {
+    BasicSnapshot<V> s{};
+    s.game = game<V>;
+    s.dice = diceRng;
+    s.ai = aiRng;
+    s.turns = turnsPlayed;
+    s.rollResult = (uint8_t)(hasRolled ? rollResult : 0);
+    s.hasRolled = hasRolled;
+    return s;
+}
+
+// Animations are not part of a snapshot: every piece is put straight on
+// its square, and an interrupted roll or AI search is dropped.
+template <class V>
+void RestoreSnapshot(const BasicSnapshot<V>& s) {
+    aiWorker<V>.Cancel();
+    game<V> = s.game;
+    diceRng = s.dice;
+    aiRng = s.ai;
+    turnsPlayed = s.turns;
+    diceRollingAnim = false; diceAnimTime = 0.0f; aiTimer = 0.0f;
+    ClearRoll();
+    if (s.hasRolled) {
+        rollResult = diceFaceDuring = pendingRoll = s.rollResult;
+        hasRolled = true;
+        legalNow = LegalMoves(game<V>, rollResult);
+    }
+    SnapAnims();
+}
+
+template <class V>
+void SeatPlayers() {
+    players.clear(); players.resize(V::PLAYERS);
+    for (int p = 0; p < V::PLAYERS; ++p) {
+        Player& pl = players[p];
+        pl.arm = V::CROSS_ARM[p];
+        pl.color = ARM_COLOR[pl.arm];
+        pl.isAI = pl.arm != HUMAN_ARM || allAi;
+    }
+}
+
+template <class V>
 void SetupPlayers() {
-    players.clear(); players.resize(4);
-    players[0].color = YELLOW; players[0].isAI = true;   // TL
-    players[1].color = BLUE;   players[1].isAI = true;   // TR
-    players[2].color = GREEN;  players[2].isAI = true;   // BL
-    players[3].color = RED;    players[3].isAI = false;  // BR (You)
-
-    for (int p = 0; p < 4; ++p) {
-        players[p].pieces.resize(4);
-        for (int i = 0; i < 4; ++i) {
-            auto& pc = players[p].pieces[i];
-            pc.player = p; pc.inHome = true; pc.inFinal = false;
-            pc.outerIdx = -1; pc.finalIdx = -1; pc.anim.active = false;
+    SeatPlayers<V>();
+    game<V> = NewGame<V>();
+    ClearRoll();
+    diceRollingAnim = false; diceAnimTime = 0.0f; aiTimer = 0.0f;
+    aiWorker<V>.Cancel();
+    diceRng = CounterRng(gameSeed, gameIndex, STREAM_DICE);
+    aiRng = CounterRng(gameSeed, gameIndex, STREAM_AI);
+    if (!replayMode) replayOut.BeginGame(gameSeed, gameIndex);
+    turnsPlayed = 0;
+    history<V>.Clear();
+    history<V>.Push(TakeSnapshot<V>());
+    autosave<V>.Write(gameSeed, gameIndex, TakeSnapshot<V>());
+}
+
+template <class V>
+void FinishDiceRoll() {
+    diceRollingAnim = false; diceAnimTime = 0;
+    rollResult = diceFaceDuring = pendingRoll; hasRolled = true;
+    legalNow = LegalMoves(game<V>, rollResult);
+}
+
+// A computer seat starts thinking as soon as the dice are thrown: the
+// result is known from then on, and the roll animation hides the search.
+template <class V>
+void ThinkAhead() {
+    const BasicGameState<V>& g = game<V>;
+    if (replayMode || simSpeed == SPEED_HEADLESS || !players[g.current].isAI) return;
+    MoveList legal = LegalMoves(g, pendingRoll);
+    if (legal.empty()) return;
+    Policy p = aiPolicy;
+    if (simSpeed == SPEED_NORMAL && p.search.timeBudgetMs > 0) p.search.timeBudgetMs = AI_THINK_MS;
+    aiWorker<V>.Post(p, g, legal, aiRng);
+}
+
+// The result is drawn up front, so every speed consumes the same dice stream.
+template <class V>
+void StartDiceRoll() {
+    pendingRoll = diceRng.RollDice();
+    ThinkAhead<V>();
+    if (simSpeed != SPEED_NORMAL) { FinishDiceRoll<V>(); return; }
+    diceRollingAnim = true;
+    diceAnimDuration = 0.8f + (rand() % 4) * 0.08f;
+    diceFaceDuring = (rand() % 6) + 1;
+}
+
+template <class V>
+Vec2i BaseCell(int player, int idx) {
+    BoardCell b = GEOMETRY<V>.base[player];
+    return { b.r + (idx / 2), b.c + (idx % 2) };
+}
+
+// Board cell a piece rests on, derived from its engine square.
+template <class V>
+Vec2i PieceCell(const BasicGameState<V>& s, int player, int idx) {
+    int sq = s.sq[player][idx];
+    if (sq == IN_BASE) return BaseCell<V>(player, idx);
+    if (IsInFinal<V>(sq)) return finalPaths[player][sq - V::LOOP_LEN];
+    return outerPath[sq];
+}
+
+template <class V>
+Vec2i PieceCell(int player, int idx) { return PieceCell(game<V>, player, idx); }
+
+template <class V>
+Vector2 GetPieceScreenPos(int player, int idx) {
+    const MoveAnim& a = players[player].anims[idx];
+    if (a.active) {
+        float t = EaseOutCubic(fminf(a.t / a.duration, 1.0f));
+        return { LerpF(a.from.x, a.to.x, t),
+                 LerpF(a.from.y, a.to.y, t) };
+    }
+    Vec2i s = PieceCell<V>(player, idx);
+    return CellCenter(s.r, s.c);
+}
+
+// Live games are logged turn by turn. The replay format only knows the
+// classic board, so duel games are not logged.
+void LogTurn(int player, Move mv, const GameState& after) {
+    replayOut.Record(player, mv, after);
+    if (IsGameOver(after)) replayOut.EndGame();
+}
+
+template <class V>
+void LogTurn(int, Move, const BasicGameState<V>&) {}
+
+// A live turn is over: log it, keep it for take-backs, checkpoint it.
+template <class V>
+void CommitTurn(int player, Move mv) {
+    replayOut.Rewind(turnsPlayed);          // no-op unless turns were taken back
+    LogTurn(player, mv, game<V>);
+    ++turnsPlayed;
+    BasicSnapshot<V> snap = TakeSnapshot<V>();
+    snap.rollResult = 0;                    // the next seat has not rolled yet
+    snap.hasRolled = 0;
+    autosave<V>.Write(gameSeed, gameIndex, snap);
+    history<V>.Push(std::move(snap));
+}
+
+// U/Y: back or forward to the previous or next turn a human plays (every
+// turn with --all-ai). The dice streams come back too, so a taken-back
+// turn rolls the same number again.
+template <class V>
+void StepHistory(bool forward) {
+    const BasicSnapshot<V>* pick = nullptr;
+    while (const BasicSnapshot<V>* s = forward ? history<V>.Redo() : history<V>.Undo()) {
+        pick = s;
+        if (allAi || !players[s->game.current].isAI) break;
+    }
+    if (pick) RestoreSnapshot(*pick);
+}
+
+// Applies the move through the engine, then animates the mover and snaps
+// any captured pieces back to base. The engine also advances the turn.
+// Replays pass record=false.
+template <class V>
+bool MovePieceBySteps(int idx, int steps, bool record = true) {
+    BasicGameState<V>& g = game<V>;
+    int player = g.current;
+    if (DestinationOf<V>(player, g.sq[player][idx], steps) < 0) return false;
+    Vector2 from = GetPieceScreenPos<V>(player, idx);
+    BasicGameState<V> before = g;
+    Move mv{ (int8_t)idx, (uint8_t)steps };
+    g = ApplyMove(g, mv);
+    if (record) CommitTurn<V>(player, mv);
+
+    Vec2i dst = PieceCell<V>(player, idx);
+    players[player].anims[idx] = { true, from, CellCenter(dst.r, dst.c), 0.0f, 0.35f };
+    for (int op = 0; op < V::PLAYERS; ++op)
+        for (int i = 0; i < NUM_PIECES; ++i)
+            if (op != player && g.sq[op][i] != before.sq[op][i]) players[op].anims[i].active = false;
+    return true;
+}
+
+template <class V>
+void PassTurn(int dice, bool record = true) {
+    BasicGameState<V>& g = game<V>;
+    int player = g.current;
+    Move mv{ (int8_t)PASS, (uint8_t)dice };
+    g = ApplyMove(g, mv);
+    if (record) CommitTurn<V>(player, mv);
+}
+
+// =================== REPLAY ===================
+// Replays are always classic four-seat games.
+bool LoadReplay(const char* path, uint64_t gameIndex) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END);
+    replayData.resize((size_t)ftell(f));
+    fseek(f, 0, SEEK_SET);
+    size_t got = fread(replayData.data(), 1, replayData.size(), f);
+    fclose(f);
+    int interval;
+    if (got != replayData.size() || !CheckReplayFileHeader(replayData.data(), replayData.size(), interval)) return false;
+    size_t at = sizeof(ReplayFileHeader);
+    while ((at = NextReplayGame(replayData.data(), replayData.size(), at, interval, replayGame)) != 0)
+        if (replayGame.header->gameIndex == gameIndex) return true;
+    return false;
+}
+
+// Jump: nearest keyframe plus fast engine moves, no animation.
+void ReplaySeek(uint32_t turn) {
+    if (turn > replayGame.turns) turn = replayGame.turns;
+    GameState s;
+    if (!SeekReplay(replayGame, turn, s)) return;
+    game<ClassicBoard> = s;
+    replayTurn = turn;
+    SnapAnims();
+    rollResult = 0;
+    if (turn > 0) { int p, d, pc; DecodeTurn(ReplayTurnByte(replayGame, turn - 1), p, d, pc); rollResult = d; }
+}
+
+// Single step forward, animated like a live move.
+void ReplayStep() {
+    if (replayTurn >= replayGame.turns) { replayAutoplay = false; return; }
+    int p, d, pc;
+    DecodeTurn(ReplayTurnByte(replayGame, replayTurn), p, d, pc);
+    if (pc == PASS) PassTurn<ClassicBoard>(d, false);
+    else MovePieceBySteps<ClassicBoard>(pc, d, false);
+    rollResult = d;
+    replayTurn++;
+}
+
+void UpdateAnims(float dt) {
+    for (auto& pl : players)
+        for (auto& a : pl.anims)
+            if (a.active) {
+                a.t += dt;
+                if (a.t >= a.duration) { a.t = a.duration; a.active = false; }
+            }
+}
+
+// =================== SIMULATION ===============
+// Game logic advances in fixed SIM_DT steps; the render loop only decides
+// how many steps a frame gets. Turbo bypasses the timers and plays whole AI
+// turns as fast as the worker answers; headless picks inline.
+template <class V>
+void PlayAiTurnNow() {
+    if (!hasRolled) {
+        if (!diceRollingAnim) pendingRoll = diceRng.RollDice();
+        FinishDiceRoll<V>();
+    }
+    if (!legalNow.empty()) {
+        Move pick;
+        {
+            PROFILE_SCOPE(PHASE_NAME[PH_AI]);
+            pick = PickPolicyMove(aiPolicy, game<V>, legalNow, aiRng);
         }
-        players[p].finished = false; players[p].finishPlace = 0;
+        MovePieceBySteps<V>(pick.piece, rollResult);
+    }
+    else {
+        PassTurn<V>(rollResult);
     }
-    currentPlayer = 3; rollResult = 0; hasRolled = false;
-    diceRollingAnim = false; diceAnimTime = 0.0f;
-    playersFinishedCount = 0; nextFinishPlace = 1;
+    ClearRoll();
+    aiTimer = 0.0f;
 }
 
-bool IsSafe(const Vec2i& v) {
-    if (v.r < 0 || v.r >= BOARD_N || v.c < 0 || v.c >= BOARD_N) return false;
-    return cellFlags[v.r][v.c] == 2;
+// Throws the dice if nobody has, then plays the worker's move; false while
+// it is still thinking. Never waits.
+template <class V>
+bool TryAiTurn() {
+    if (!hasRolled) {
+        if (!diceRollingAnim) { pendingRoll = diceRng.RollDice(); ThinkAhead<V>(); }
+        FinishDiceRoll<V>();
+    }
+    if (!legalNow.empty()) {
+        if (!aiWorker<V>.Pending()) ThinkAhead<V>();
+        Move pick;
+        if (!aiWorker<V>.Poll(pick, aiRng)) return false;
+        MovePieceBySteps<V>(pick.piece, rollResult);
+    }
+    else {
+        PassTurn<V>(rollResult);
+    }
+    ClearRoll();
+    aiTimer = 0.0f;
+    return true;
 }
 
-Vector2 GetPieceScreenPos(const Piece& pc, int idx) {
-    if (pc.anim.active) {
-        float t = EaseOutCubic(fminf(pc.anim.t / pc.anim.duration, 1.0f));
-        return { LerpF(pc.anim.from.x, pc.anim.to.x, t),
-                 LerpF(pc.anim.from.y, pc.anim.to.y, t) };
+template <class V>
+void SimTick(float dt) {
+    globalTime += dt;
+    {
+        PROFILE_SCOPE(PHASE_NAME[PH_ANIMS]);
+        UpdateAnims(dt);
     }
-    if (pc.inHome) {
-        int p = pc.player; int hr = (p <= 1) ? 0 : (BOARD_N - 3), hc = (p == 0 || p == 2) ? 0 : (BOARD_N - 3);
-        return CellCenter(hr + (idx / 2), hc + (idx % 2));
+
+    // Dice animation tick
+    if (diceRollingAnim) {
+        PROFILE_SCOPE(PHASE_NAME[PH_DICE]);
+        diceAnimTime += dt;
+        if (diceAnimTime >= diceAnimDuration) FinishDiceRoll<V>();
+        else if (fmod(globalTime, 0.08f) < 0.04f) diceFaceDuring = (rand() % 6) + 1;
     }
-    if (pc.inFinal) {
-        Vec2i s = finalPaths[pc.player][pc.finalIdx];
-        return CellCenter(s.r, s.c);
+
+    if (replayMode) {
+        replayTimer += dt;
+        if (replayAutoplay && replayTimer >= 0.4f) { replayTimer = 0.0f; ReplayStep(); }
+        return;
     }
-    Vec2i s = outerPath[pc.outerIdx];
-    return CellCenter(s.r, s.c);
+    if (IsGameOver(game<V>) || !players[game<V>.current].isAI) return;
+
+    // AI seat: roll, then move, each after AI_DELAY; the move also waits
+    // (tick after tick, not blocking) for the worker's answer.
+    aiTimer += dt;
+    if (aiTimer < AI_DELAY) return;
+    if (hasRolled) { TryAiTurn<V>(); return; }
+    aiTimer = 0.0f;
+    if (!diceRollingAnim) StartDiceRoll<V>();
 }
 
-void StartAnim(Piece& pc, Vector2 dest) {
-    pc.anim.active = true; pc.anim.from = GetPieceScreenPos(pc, 0);
-    pc.anim.to = dest; pc.anim.t = 0.0f; pc.anim.duration = 0.35f;
-}
-
-void SpawnFromHome(int player, int pieceIdx) {
-    Piece& pc = players[player].pieces[pieceIdx];
-    pc.inHome = false; pc.inFinal = false; pc.outerIdx = startIndexFor[player]; pc.finalIdx = -1;
-    int hr = (player <= 1) ? 0 : (BOARD_N - 3), hc = (player == 0 || player == 2) ? 0 : (BOARD_N - 3);
-    Vector2 from = CellCenter(hr + (pieceIdx / 2), hc + (pieceIdx % 2));
-    Vec2i startCell = outerPath[pc.outerIdx];
-    Vector2 to = CellCenter(startCell.r, startCell.c);
-    pc.anim = { true,from,to,0.0f,0.35f };
-}
-
-bool MovePieceBySteps(int player, int idx, int steps) {
-    Piece& pc = players[player].pieces[idx];
-
-    if (pc.inHome) {
-        if (steps == 6) { SpawnFromHome(player, idx); return true; }
-        return false;
-    }
-    if (pc.inFinal) {
-        int nf = pc.finalIdx + steps;
-        if (nf > 5) return false;
-        pc.finalIdx = nf;
-        Vec2i s = finalPaths[player][nf];
-        StartAnim(pc, CellCenter(s.r, s.c));
-        if (nf == 5) {
-            bool allDone = true;
-            for (auto& q : players[player].pieces)
-                if (!(q.inFinal && q.finalIdx == 5)) { allDone = false; break; }
-            if (allDone && !players[player].finished) {
-                players[player].finished = true;
-                players[player].finishPlace = nextFinishPlace++;
-                playersFinishedCount++;
-            }
+// Turbo: up to turboTurnsPerFrame turns, then one frame is drawn.
+template <class V>
+void TurboAdvance(float dt) {
+    globalTime += dt;
+    for (int n = 0; n < turboTurnsPerFrame; ++n) {
+        if (replayMode) {
+            if (!replayAutoplay) break;
+            ReplayStep();
+        }
+        else {
+            if (IsGameOver(game<V>) || !players[game<V>.current].isAI) break;
+            if (!TryAiTurn<V>()) break;         // still thinking; look again next frame
+        }
+    }
+    SnapAnims();
+}
+
+// --headless N: N all-AI games back to back (dice streams (seed, 0..N-1)),
+// logged like live games, as fast as the AI allows.
+template <class V>
+int RunHeadless(uint64_t games) {
+    simSpeed = SPEED_HEADLESS;
+    allAi = true;
+    BuildBoardAndPaths<V>();
+    uint64_t turns = 0, unfinished = 0, wins[V::PLAYERS] = {};
+    auto t0 = std::chrono::steady_clock::now();
+    for (gameIndex = 0; gameIndex < games; ++gameIndex) {
+        SetupPlayers<V>();
+        uint32_t plies = 0;
+        while (!IsGameOver(game<V>) && plies < MAX_PLIES) { PlayAiTurnNow<V>(); plies++; }
+        if (!IsGameOver(game<V>)) { replayOut.EndGame(); unfinished++; }
+        turns += plies;
+        for (int p = 0; p < V::PLAYERS; ++p) if (game<V>.finishPlace[p] == 1) wins[p]++;
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    printf("%llu games, %llu turns in %.3f s (%.1f games/s, %.0f turns/s), policy %s\n",
+        (unsigned long long)games, (unsigned long long)turns, secs, secs > 0 ? games / secs : 0.0,
+        secs > 0 ? turns / secs : 0.0, PolicyName(aiPolicy.kind));
+    printf("wins");
+    for (int p = 0; p < V::PLAYERS; ++p) printf("  %s %llu", ARM_NAME[players[p].arm], (unsigned long long)wins[p]);
+    printf("\n");
+    if (unfinished) printf("unfinished %llu (hit MAX_PLIES)\n", (unsigned long long)unfinished);
+    return 0;
+}
+
+// =================== BOARD LAYER ==============
+// Everything that never changes during a game is drawn once into a render
+// texture and shown as a single quad; only pieces, highlights, dice and the
+// sidebar are drawn per frame.
+RenderTexture2D boardLayer{};
+int boardLayerCell = 0, boardLayerSize = 0, boardLayerScrW = 0, boardLayerScrH = 0, boardLayerVersion = -1;
+
+void DrawStaticBoard() {
+    // Board grid
+    for (int r = 0; r < BOARD_N; ++r)
+        for (int c = 0; c < BOARD_N; ++c)
+            DrawRectangleLines(c * CELL, r * CELL, CELL, CELL, BLACK);
+
+    // 4 home quadrants
+    DrawRectangle(0, 0, 6 * CELL, 6 * CELL, RED);
+    DrawRectangle(9 * CELL, 0, 6 * CELL, 6 * CELL, GREEN);
+    DrawRectangle(0, 9 * CELL, 6 * CELL, 6 * CELL, BLUE);
+    DrawRectangle(9 * CELL, 9 * CELL, 6 * CELL, 6 * CELL, YELLOW);
+
+    // Loop cells visualized directly from outerPath
+    for (size_t i = 0; i < outerPath.size(); ++i) {
+        Vec2i p = outerPath[i];
+        Rectangle rc{ (float)p.c * CELL, (float)p.r * CELL, (float)CELL, (float)CELL };
+        DrawRectangleRec(rc, WHITE);
+        DrawRectangleLinesEx(rc, 1.0f, BLACK);
+        // Mark true safe cells only (starts + center)
+        if (cellFlags[p.r][p.c] == 2) {
+            DrawCircle(rc.x + CELL * 0.5f, rc.y + CELL * 0.5f, CELL * 0.18f, LIGHTGRAY);
+            DrawStarOutline((int)(rc.x + CELL * 0.5f), (int)(rc.y + CELL * 0.5f), CELL * 0.20f, DARKGRAY);
+        }
+    }
+    // Center safe (6,6) already part of loop visuals via flags
+
+    // Final colored strips of the seats in play (use finalPaths; last square solid color)
+    for (size_t pl = 0; pl < finalPaths.size(); ++pl) {
+        Color homeC = players[pl].color;
+        for (size_t k = 0; k < finalPaths[pl].size(); ++k) {
+            Vec2i p = finalPaths[pl][k];
+            Rectangle rc{ (float)p.c * CELL, (float)p.r * CELL, (float)CELL, (float)CELL };
+            Color col = (k + 1 == finalPaths[pl].size()) ? homeC : ColorAlpha(homeC, 0.55f);
+            DrawRectangleRec(rc, col);
+            DrawRectangleLinesEx(rc, 1.0f, BLACK);
         }
-        return true;
-    }
-    // on loop
-    int ni = pc.outerIdx + steps;
-    if (ni < (int)outerPath.size()) {
-        pc.outerIdx = ni;
-        Vec2i dst = outerPath[pc.outerIdx];
-        StartAnim(pc, CellCenter(dst.r, dst.c));
-        if (!IsSafe(dst)) {
-            for (int op = 0; op < 4; ++op) if (op != player) {
-                for (auto& opp : players[op].pieces) {
-                    if (!opp.inHome && !opp.inFinal && opp.outerIdx == pc.outerIdx) {
-                        opp.inHome = true; opp.inFinal = false; opp.outerIdx = -1; opp.finalIdx = -1; opp.anim.active = false;
+    }
+
+    // Center base + triangles + trophy
+    int cx = BOARD_W / 2, cy = BOARD_W / 2;
+    DrawRectangle(6 * CELL, 6 * CELL, 3 * CELL, 3 * CELL, WHITE);
+    DrawTriangle({ (float)cx,(float)cy }, { (float)6 * CELL,(float)6 * CELL }, { (float)9 * CELL,(float)6 * CELL }, RED);
+    DrawTriangle({ (float)cx,(float)cy }, { (float)9 * CELL,(float)6 * CELL }, { (float)9 * CELL,(float)9 * CELL }, GREEN);
+    DrawTriangle({ (float)cx,(float)cy }, { (float)6 * CELL,(float)9 * CELL }, { (float)9 * CELL,(float)9 * CELL }, YELLOW);
+    DrawTriangle({ (float)cx,(float)cy }, { (float)6 * CELL,(float)6 * CELL }, { (float)6 * CELL,(float)9 * CELL }, BLUE);
+    DrawTrophy(cx, cy, CELL * 0.9f, GOLD);
+}
+
+// Re-renders the cached board, `size` pixels square (the spectator grid
+// scales it down), when the layout, CELL, size or window size changed.
+void EnsureBoardLayer(int size = BOARD_W) {
+    int w = GetScreenWidth(), h = GetScreenHeight();
+    if (boardLayer.id != 0 && boardLayerCell == CELL && boardLayerSize == size && boardLayerScrW == w
+        && boardLayerScrH == h && boardLayerVersion == boardLayoutVersion) return;
+    if (boardLayer.id != 0) UnloadRenderTexture(boardLayer);
+    boardLayer = LoadRenderTexture(size, size);
+    BeginTextureMode(boardLayer);
+    ClearBackground(RAYWHITE);
+    BeginMode2D(Camera2D{ { 0, 0 }, { 0, 0 }, 0.0f, (float)size / BOARD_W });
+    DrawStaticBoard();
+    EndMode2D();
+    EndTextureMode();
+    boardLayerCell = CELL; boardLayerSize = size; boardLayerScrW = w; boardLayerScrH = h;
+    boardLayerVersion = boardLayoutVersion;
+}
+
+// =================== FRAME ====================
+// Input (once per frame; the simulation only consumes time).
+template <class V>
+void HandleInput(Vector2 mouse, const Rectangle& rollBtn) {
+    const BasicGameState<V>& g = game<V>;
+    if (replayMode) {
+        if (IsKeyPressed(KEY_RIGHT)) ReplayStep();
+        if (IsKeyPressed(KEY_LEFT) && replayTurn > 0) ReplaySeek(replayTurn - 1);
+        if (IsKeyPressed(KEY_HOME)) ReplaySeek(0);
+        if (IsKeyPressed(KEY_END)) ReplaySeek(replayGame.turns);
+        if (IsKeyPressed(KEY_SPACE)) replayAutoplay = !replayAutoplay;
+    }
+    else if (IsGameOver(g)) {
+        // nothing left to play; keep drawing the final board
+    }
+    else if (!players[g.current].isAI) {
+        if (IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) {
+            if (!hasRolled && CheckCollisionPointRec(mouse, rollBtn)) {
+                StartDiceRoll<V>();
+            }
+            else if (hasRolled) {
+                if (!legalNow.empty()) {
+                    for (const Move& mv : legalNow) {
+                        Vector2 pos = GetPieceScreenPos<V>(g.current, mv.piece);
+                        Rectangle r = { pos.x - 18, pos.y - 18, 36, 36 };
+                        if (CheckCollisionPointRec(mouse, r)) {
+                            if (MovePieceBySteps<V>(mv.piece, rollResult)) ClearRoll();
+                            break;
+                        }
                     }
                 }
+                else {
+                    PassTurn<V>(rollResult);
+                    ClearRoll();
+                }
             }
         }
-        return true;
+        if (IsKeyPressed(KEY_SPACE) && !hasRolled && !diceRollingAnim) {
+            StartDiceRoll<V>();
+        }
     }
-    else {
-        int excess = ni - ((int)outerPath.size() - 1); // 1..6 to enter final
-        if (excess >= 1 && excess <= 6) {
-            pc.inFinal = true; pc.outerIdx = -1; pc.finalIdx = excess - 1;
-            Vec2i s = finalPaths[player][pc.finalIdx];
-            StartAnim(pc, CellCenter(s.r, s.c));
-            if (pc.finalIdx == 5) {
-                bool allDone = true;
-                for (auto& q : players[player].pieces)
-                    if (!(q.inFinal && q.finalIdx == 5)) { allDone = false; break; }
-                if (allDone && !players[player].finished) {
-                    players[player].finished = true;
-                    players[player].finishPlace = nextFinishPlace++;
-                    playersFinishedCount++;
-                }
+}
+
+template <class V>
+void DrawPieces() {
+    const BasicGameState<V>& g = game<V>;
+    // Occupancy for slight offsets (plain arrays: no allocation per frame)
+    uint8_t cellCount[BOARD_N][BOARD_N] = {}, cellDrawn[BOARD_N][BOARD_N] = {};
+    for (int p = 0; p < V::PLAYERS; ++p)
+        for (int i = 0; i < NUM_PIECES; ++i) { Vec2i v = PieceCell<V>(p, i); cellCount[v.r][v.c]++; }
+
+    for (int p = 0; p < V::PLAYERS; ++p) {
+        for (int i = 0; i < NUM_PIECES; ++i) {
+            const MoveAnim& anim = players[p].anims[i];
+            Vector2 base = GetPieceScreenPos<V>(p, i);
+            Vec2i v = PieceCell<V>(p, i);
+            int count = cellCount[v.r][v.c], order = cellDrawn[v.r][v.c]++;
+            float off = (order - (count - 1) / 2.0f) * 10.0f;
+            Vector2 pos{ base.x + off, base.y - off };
+
+            bool canPick = (!IsGameOver(g) && !players[p].isAI && p == g.current && hasRolled
+                && legalNow.Contains(i));
+
+            float rad = 14.0f + (anim.active ? 2.0f * (1.0f - anim.t / anim.duration) : 0.0f);
+            DrawCircleV(pos, rad, players[p].color);
+            DrawStarOutline((int)pos.x, (int)pos.y, rad * 0.6f, WHITE);
+            if (canPick) {
+                float ring = rad + 6 + (sinf(globalTime * 6.0f) + 1.0f) * 2.0f;
+                DrawCircleLines((int)pos.x, (int)pos.y, ring, ColorAlpha(players[p].color, 0.9f));
             }
-            return true;
         }
-        return false;
     }
 }
 
-std::vector<int> GetLegal(int player, int dice) {
-    std::vector<int> r;
-    for (int i = 0; i < 4; ++i) {
-        Piece& pc = players[player].pieces[i];
-        if (pc.inHome) { if (dice == 6) r.push_back(i); }
-        else if (pc.inFinal) { if (dice <= (5 - pc.finalIdx)) r.push_back(i); }
-        else {
-            int ni = pc.outerIdx + dice;
-            if (ni < (int)outerPath.size() || (ni - ((int)outerPath.size() - 1)) <= 6) r.push_back(i);
-        }
+// Per-phase timings over the last PROFILE_WINDOW_NS and a frame-time graph,
+// drawn over the lower sidebar.
+void DrawProfilerOverlay() {
+    profileView.Update(Profiler(), PROFILE_WINDOW_NS);
+    int x = BOARD_W + 10, y = 140, w = SIDEBAR_W - 20;
+    DrawRectangle(x, y, w, 390, ColorAlpha(BLACK, 0.82f));
+    DrawText(TextFormat("Profiler  %u frames / 2 s", profileView.frames), x + 8, y + 6, 16, RAYWHITE);
+    DrawText("phase          calls   avg ms   p99 ms", x + 8, y + 28, 12, GRAY);
+    y += 44;
+    for (const PhaseStat& st : profileView.phases) {
+        DrawText(st.name, x + 8, y, 12, RAYWHITE);
+        DrawText(TextFormat("%5u  %7.3f  %7.3f", st.calls, st.avgMs, st.p99Ms), x + 110, y, 12, RAYWHITE);
+        y += 16;
+    }
+
+    // Frame times, newest on the right; the line marks 60 FPS.
+    const float GRAPH_MS = 33.3f, BUDGET_MS = 1000.0f / 60.0f;
+    Rectangle gr{ (float)x + 8, (float)y + 10, (float)w - 16, 90 };
+    DrawRectangleLinesEx(gr, 1.0f, DARKGRAY);
+    size_t n = profileView.frameMs.size();
+    float barW = gr.width / 120.0f;
+    for (size_t i = 0; i < n; ++i) {
+        float ms = profileView.frameMs[i];
+        float h = fminf(ms / GRAPH_MS, 1.0f) * gr.height;
+        float bx = gr.x + gr.width - (float)(n - i) * barW;
+        DrawRectangleRec({ bx, gr.y + gr.height - h, fmaxf(barW - 1.0f, 1.0f), h }, ms > BUDGET_MS * 1.5f ? RED : LIME);
     }
-    return r;
+    float budgetY = gr.y + gr.height - BUDGET_MS / GRAPH_MS * gr.height;
+    DrawLineV({ gr.x, budgetY }, { gr.x + gr.width, budgetY }, YELLOW);
+    y = (int)(gr.y + gr.height) + 8;
+    const char* dump = lastTraceEvents > 0 ? TextFormat("D: dump trace  (last: %ld events)", lastTraceEvents)
+        : lastTraceEvents < 0 ? "D: dump trace  (last dump failed)" : "D: dump trace";
+    DrawText(dump, x + 8, y, 12, GRAY);
 }
 
-void UpdateAnims(float dt) {
-    for (auto& pl : players)
-        for (auto& pc : pl.pieces)
-            if (pc.anim.active) {
-                pc.anim.t += dt;
-                if (pc.anim.t >= pc.anim.duration) { pc.anim.t = pc.anim.duration; pc.anim.active = false; }
+template <class V>
+void DrawSidebar(const Rectangle& rollBtn) {
+    const BasicGameState<V>& g = game<V>;
+    DrawRectangle(BOARD_W, 0, SIDEBAR_W, SCR_H, LIGHTGRAY);
+    DrawText("Ludo", BOARD_W + 30, 24, 36, BLACK);
+    DrawText(TextFormat("Turn: %s", SeatLabel(g.current)), BOARD_W + 30, 74, 22, BLACK);
+    if (hasRolled && aiWorker<V>.Pending()) DrawText("thinking...", BOARD_W + 190, 80, 16, DARKGRAY);
+    if (replayMode)
+        DrawText(TextFormat("Replay turn %u / %u  (<- -> Home End Space)", replayTurn, replayGame.turns),
+            BOARD_W + 30, 104, 14, DARKGRAY);
+    else
+        DrawText(TextFormat("Seed: %llu  game %llu  (N: new game)", (unsigned long long)gameSeed,
+            (unsigned long long)gameIndex), BOARD_W + 30, 104, 14, DARKGRAY);
+    DrawText(simSpeed == SPEED_TURBO ? TextFormat("TURBO x%d  (T: normal speed, P: profiler)", turboTurnsPerFrame)
+        : "T: turbo  P: profiler  U/Y: undo", BOARD_W + 30, 120, 14, simSpeed == SPEED_TURBO ? MAROON : DARKGRAY);
+
+    // Dice + roll button
+    Rectangle diceBox = { BOARD_W + 40, SCR_H - 100, 60, 60 };
+    DrawDiceFace(diceRollingAnim ? diceFaceDuring : ((hasRolled || replayMode) ? rollResult : 0),
+        diceBox.x, diceBox.y, diceBox.width, WHITE, BLACK);
+
+    Color btnColor = ColorAlpha(GREEN, diceRollingAnim ? 0.9f : (hasRolled ? 0.55f : 0.85f));
+    DrawRectangleRounded(rollBtn, 0.18f, 6, btnColor);
+    DrawRectangleRoundedLines(rollBtn, 0.18f, 6, BLACK);
+    DrawText(hasRolled ? "Select Piece" : "Roll Dice",
+        rollBtn.x + 20, rollBtn.y + 18, 24, BLACK);
+
+    // Finish order
+    int y = 140;
+    DrawText("Finish Order:", BOARD_W + 30, y, 20, BLACK); y += 28;
+    for (int place = 1; place <= V::PLAYERS; ++place) {
+        for (int p = 0; p < V::PLAYERS; ++p) if (g.finishPlace[p] == place) {
+            DrawText(TextFormat("%d) %s", place, SeatLabel(p)), BOARD_W + 40, y, 18, players[p].color);
+            y += 22;
+        }
+    }
+
+    // Chances of the next place, re-estimated whenever the position changes
+    const OddsEstimate& odds = oddsMeter<V>.Update(g);
+    if (!IsGameOver(g)) {
+        y += 10;
+        DrawText(g.nextPlace == 1 ? "Win Chance:" : TextFormat("Chance of Place %d:", g.nextPlace), BOARD_W + 30, y, 20, BLACK);
+        y += 28;
+        bool shown = odds.exact || odds.samples > 0;
+        for (int p = 0; p < V::PLAYERS; ++p) {
+            if (IsFinished(g, p)) continue;
+            DrawText(SeatLabel(p), BOARD_W + 40, y, 16, players[p].color);
+            DrawRectangleLines(BOARD_W + 130, y + 1, 100, 14, GRAY);
+            if (shown) {
+                DrawRectangle(BOARD_W + 130, y + 1, (int)(100 * odds.chance[p] + 0.5f), 14, players[p].color);
+                DrawText(TextFormat("%3.0f%%", 100 * odds.chance[p]), BOARD_W + 238, y, 16, BLACK);
             }
+            y += 20;
+        }
+        DrawText(odds.exact ? "exact (race)" : shown ? TextFormat("%u rollouts", odds.samples) : "estimating...",
+            BOARD_W + 40, y + 2, 12, DARKGRAY);
+    }
+
+    if (AllocCountingEnabled())
+        DrawText(TextFormat("Allocs/frame: %llu (peak %llu)", (unsigned long long)frameAllocs,
+            (unsigned long long)steadyAllocPeak), BOARD_W + 30, SCR_H - 130, 16, DARKGRAY);
+
+    if (profilerOverlay) DrawProfilerOverlay();
 }
 
-// =================== MAIN =====================
-int main() {
+// Window and frame loop for board variant V.
+template <class V>
+void RunWindow() {
     InitWindow(SCR_W, SCR_H, "Ludo (clean visuals + core mechanics)");
     SetTargetFPS(60);
-    srand((unsigned)time(nullptr));
+    srand((unsigned)time(nullptr));              // dice animation faces only
 
-    BuildBoardAndPaths();
-    SetupPlayers();
+    BuildBoardAndPaths<V>();
+    SetupPlayers<V>();
+    if (resumeGame) {
+        BasicSnapshot<V> snap;
+        if (LoadSnapshotFile(SNAPSHOT_OUT, gameSeed, gameIndex, snap)) {
+            RestoreSnapshot(snap);
+            history<V>.Clear();
+            history<V>.Push(std::move(snap));
+        }
+        else fprintf(stderr, "no saved %d-player game in %s, starting a new one\n", V::PLAYERS, SNAPSHOT_OUT);
+    }
+    if (!replayMode && autosave<V>.Open(SNAPSHOT_OUT)) autosave<V>.Write(gameSeed, gameIndex, TakeSnapshot<V>());
 
     Rectangle rollBtn = { (float)(BOARD_W + 40), (float)(SCR_H - 100), 200, 60 };
 
     while (!WindowShouldClose()) {
+        PROFILE_SCOPE(PHASE_NAME[PH_FRAME]);
+        AllocScope frameScope;
         float dt = GetFrameTime();
-        globalTime += dt;
-        UpdateAnims(dt);
+        Vector2 mouse = GetMousePosition();
 
-        // Dice animation tick
-        if (diceRollingAnim) {
-            diceAnimTime += dt;
-            if (diceAnimTime >= diceAnimDuration) {
-                diceRollingAnim = false; diceAnimTime = 0;
-                rollResult = diceFaceDuring; hasRolled = true;
-            }
-            else if (fmod(globalTime, 0.08f) < 0.04f) {
-                diceFaceDuring = (rand() % 6) + 1;
-            }
+        if (IsKeyPressed(KEY_T)) {
+            simSpeed = (simSpeed == SPEED_TURBO) ? SPEED_NORMAL : SPEED_TURBO;
+            if (diceRollingAnim) FinishDiceRoll<V>();
+            simAccum = 0.0f;
+        }
+        if (IsKeyPressed(KEY_N) && !replayMode) {         // new game: the next dice stream of this seed
+            if (!IsGameOver(game<V>)) replayOut.EndGame();
+            ++gameIndex;
+            SetupPlayers<V>();
+            SnapAnims();
         }
+        if (IsKeyPressed(KEY_U) && !replayMode) StepHistory<V>(false);
+        if (IsKeyPressed(KEY_Y) && !replayMode) StepHistory<V>(true);
+        if (IsKeyPressed(KEY_P)) profilerOverlay = !profilerOverlay;
+        if (IsKeyPressed(KEY_D)) lastTraceEvents = WriteChromeTrace(Profiler(), TRACE_OUT);
 
-        Vector2 mouse = GetMousePosition();
+        {
+            PROFILE_SCOPE(PHASE_NAME[PH_INPUT]);
+            HandleInput<V>(mouse, rollBtn);
+        }
 
-        // Turn handling
-        if (!players[currentPlayer].isAI) {
-            if (IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) {
-                if (!hasRolled && CheckCollisionPointRec(mouse, rollBtn)) {
-                    diceRollingAnim = true;
-                    diceAnimDuration = 0.8f + (rand() % 4) * 0.08f;
-                    diceFaceDuring = (rand() % 6) + 1;
-                }
-                else if (hasRolled) {
-                    auto legal = GetLegal(currentPlayer, rollResult);
-                    if (!legal.empty()) {
-                        for (int idx : legal) {
-                            Vector2 pos = GetPieceScreenPos(players[currentPlayer].pieces[idx], idx);
-                            Rectangle r = { pos.x - 18, pos.y - 18, 36, 36 };
-                            if (CheckCollisionPointRec(mouse, r)) {
-                                if (MovePieceBySteps(currentPlayer, idx, rollResult)) {
-                                    bool extra = (rollResult == 6);
-                                    hasRolled = false; rollResult = 0;
-                                    if (!extra) {
-                                        int nxt = (currentPlayer + 1) % 4;
-                                        while (players[nxt].finished) nxt = (nxt + 1) % 4;
-                                        currentPlayer = nxt;
-                                    }
-                                }
-                                break;
-                            }
-                        }
-                    }
-                    else {
-                        hasRolled = false; rollResult = 0;
-                        int nxt = (currentPlayer + 1) % 4;
-                        while (players[nxt].finished) nxt = (nxt + 1) % 4;
-                        currentPlayer = nxt;
-                    }
-                }
-            }
-            if (IsKeyPressed(KEY_SPACE) && !hasRolled && !diceRollingAnim) {
-                diceRollingAnim = true;
-                diceAnimDuration = 0.8f + (rand() % 4) * 0.08f;
-                diceFaceDuring = (rand() % 6) + 1;
-            }
+        // Simulation
+        if (simSpeed == SPEED_TURBO) {
+            TurboAdvance<V>(dt);
         }
         else {
-            // Simple AI
-            static float aiT = 0.0f; aiT += dt;
-            if (aiT >= 0.6f) {
-                aiT = 0.0f;
-                if (!hasRolled && !diceRollingAnim) {
-                    diceRollingAnim = true;
-                    diceAnimDuration = 0.8f + (rand() % 4) * 0.08f;
-                    diceFaceDuring = (rand() % 6) + 1;
-                }
-                else if (hasRolled) {
-                    auto legal = GetLegal(currentPlayer, rollResult);
-                    if (!legal.empty()) {
-                        int pick = legal[0], best = -999;
-                        for (int idx : legal) {
-                            int score = 0;
-                            Piece& pc = players[currentPlayer].pieces[idx];
-                            if (pc.inHome && rollResult == 6) score += 10;
-                            if (pc.inFinal && pc.finalIdx + rollResult == 5) score += 50;
-                            if (!pc.inHome && !pc.inFinal) {
-                                int ni = pc.outerIdx + rollResult;
-                                if (ni < (int)outerPath.size()) {
-                                    Vec2i dst = outerPath[ni];
-                                    if (!IsSafe(dst)) score += 20; // possible capture
-                                }
-                            }
-                            score += rand() % 3;
-                            if (score > best) { best = score; pick = idx; }
-                        }
-                        MovePieceBySteps(currentPlayer, pick, rollResult);
-                    }
-                    bool extra = (rollResult == 6);
-                    hasRolled = false; rollResult = 0;
-                    if (!extra) {
-                        int nxt = (currentPlayer + 1) % 4;
-                        while (players[nxt].finished) nxt = (nxt + 1) % 4;
-                        currentPlayer = nxt;
-                    }
-                }
-            }
-        }
-
-        // If 3 finished, give last place automatically
-        if (playersFinishedCount >= 3) {
-            for (int p = 0; p < 4; ++p) if (!players[p].finished) {
-                players[p].finished = true; players[p].finishPlace = nextFinishPlace++;
+            simAccum += dt;
+            for (int steps = 0; simAccum >= SIM_DT; ++steps) {
+                if (steps == MAX_SIM_STEPS) { simAccum = 0.0f; break; }
+                SimTick<V>(SIM_DT);
+                simAccum -= SIM_DT;
             }
         }
 
         // =================== DRAW ===================
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
-
-        // Board grid
-        for (int r = 0; r < BOARD_N; ++r)
-            for (int c = 0; c < BOARD_N; ++c)
-                DrawRectangleLines(c * CELL, r * CELL, CELL, CELL, BLACK);
-
-        // 4 home quadrants
-        DrawRectangle(0, 0, 6 * CELL, 6 * CELL, RED);
-        DrawRectangle(9 * CELL, 0, 6 * CELL, 6 * CELL, GREEN);
-        DrawRectangle(0, 9 * CELL, 6 * CELL, 6 * CELL, BLUE);
-        DrawRectangle(9 * CELL, 9 * CELL, 6 * CELL, 6 * CELL, YELLOW);
-
-        // Loop cells visualized directly from outerPath
-        for (size_t i = 0; i < outerPath.size(); ++i) {
-            Vec2i p = outerPath[i];
-            Rectangle rc{ (float)p.c * CELL, (float)p.r * CELL, (float)CELL, (float)CELL };
-            DrawRectangleRec(rc, WHITE);
-            DrawRectangleLinesEx(rc, 1.0f, BLACK);
-            // Mark true safe cells only (starts + center)
-            if (cellFlags[p.r][p.c] == 2) {
-                DrawCircle(rc.x + CELL * 0.5f, rc.y + CELL * 0.5f, CELL * 0.18f, LIGHTGRAY);
-                DrawStarOutline((int)(rc.x + CELL * 0.5f), (int)(rc.y + CELL * 0.5f), CELL * 0.20f, DARKGRAY);
-            }
+        {
+            PROFILE_SCOPE(PHASE_NAME[PH_BOARD]);
+            EnsureBoardLayer();
+            BeginDrawing();
+            ClearBackground(RAYWHITE);
+
+            // Static board: one textured quad (render textures are stored upside down)
+            DrawTextureRec(boardLayer.texture, { 0, 0, (float)boardLayer.texture.width, -(float)boardLayer.texture.height },
+                { boardRect.x, boardRect.y }, WHITE);
         }
-        // Center safe (6,6) already part of loop visuals via flags
-
-        // Final colored strips (use finalPaths; last square solid color)
-        Color homeC[4] = { YELLOW, BLUE, GREEN, RED };
-        for (int pl = 0; pl < 4; ++pl) {
-            for (int k = 0; k < 6; ++k) {
-                Vec2i p = finalPaths[pl][k];
-                Rectangle rc{ (float)p.c * CELL, (float)p.r * CELL, (float)CELL, (float)CELL };
-                Color col = (k == 5) ? homeC[pl] : ColorAlpha(homeC[pl], 0.55f);
-                DrawRectangleRec(rc, col);
-                DrawRectangleLinesEx(rc, 1.0f, BLACK);
-            }
+        {
+            PROFILE_SCOPE(PHASE_NAME[PH_PIECES]);
+            DrawPieces<V>();
+        }
+        {
+            PROFILE_SCOPE(PHASE_NAME[PH_SIDEBAR]);
+            DrawSidebar<V>(rollBtn);
+        }
+        {
+            PROFILE_SCOPE(PHASE_NAME[PH_PRESENT]);      // includes the wait for the next vsync
+            EndDrawing();
         }
 
-        // Center base + triangles + trophy
-        int cx = BOARD_W / 2, cy = BOARD_W / 2;
-        DrawRectangle(6 * CELL, 6 * CELL, 3 * CELL, 3 * CELL, WHITE);
-        DrawTriangle({ (float)cx,(float)cy }, { (float)6 * CELL,(float)6 * CELL }, { (float)9 * CELL,(float)6 * CELL }, RED);
-        DrawTriangle({ (float)cx,(float)cy }, { (float)9 * CELL,(float)6 * CELL }, { (float)9 * CELL,(float)9 * CELL }, GREEN);
-        DrawTriangle({ (float)cx,(float)cy }, { (float)6 * CELL,(float)9 * CELL }, { (float)9 * CELL,(float)9 * CELL }, YELLOW);
-        DrawTriangle({ (float)cx,(float)cy }, { (float)6 * CELL,(float)6 * CELL }, { (float)6 * CELL,(float)9 * CELL }, BLUE);
-        DrawTrophy(cx, cy, CELL * 0.9f, GOLD);
-
-        // Occupancy for slight offsets
-        std::map<std::pair<int, int>, int> occ, drew;
-        auto keyOf = [&](const Piece& pc, int i) {
-            if (pc.inHome) {
-                int p = pc.player; int hr = (p <= 1) ? 0 : (BOARD_N - 3), hc = (p == 0 || p == 2) ? 0 : (BOARD_N - 3);
-                return std::pair<int, int>{ hr + (i / 2), hc + (i % 2) };
-            }
-            else if (pc.inFinal) {
-                Vec2i v = finalPaths[pc.player][pc.finalIdx];
-                return std::pair<int, int>{ v.r, v.c };
-            }
-            else {
-                Vec2i v = outerPath[pc.outerIdx];
-                return std::pair<int, int>{ v.r, v.c };
-            }
-            };
-        for (int p = 0; p < 4; ++p) for (int i = 0; i < 4; ++i) occ[keyOf(players[p].pieces[i], i)]++;
-
-        // Draw pieces
-        for (int p = 0; p < 4; ++p) {
-            for (int i = 0; i < 4; ++i) {
-                Piece& pc = players[p].pieces[i];
-                Vector2 base = GetPieceScreenPos(pc, i);
-                auto k = keyOf(pc, i);
-                int count = occ[k], order = drew[k]++;
-                float off = (order - (count - 1) / 2.0f) * 10.0f;
-                Vector2 pos{ base.x + off, base.y - off };
-
-                bool canPick = (!players[p].isAI && p == currentPlayer && hasRolled);
-                if (canPick) {
-                    auto legal = GetLegal(p, rollResult);
-                    canPick = std::find(legal.begin(), legal.end(), i) != legal.end();
-                }
+        frameAllocs = frameScope.Count();
+        if (++frameNo > ALLOC_WARMUP_FRAMES && frameAllocs > steadyAllocPeak) steadyAllocPeak = frameAllocs;
+    }
 
-                float rad = 14.0f + (pc.anim.active ? 2.0f * (1.0f - pc.anim.t / pc.anim.duration) : 0.0f);
-                DrawCircleV(pos, rad, players[p].color);
-                DrawStarOutline((int)pos.x, (int)pos.y, rad * 0.6f, WHITE);
-                if (canPick) {
-                    float ring = rad + 6 + (sinf(globalTime * 6.0f) + 1.0f) * 2.0f;
-                    DrawCircleLines((int)pos.x, (int)pos.y, ring, ColorAlpha(players[p].color, 0.9f));
+    aiWorker<V>.Cancel();
+    autosave<V>.Close();
+    if (boardLayer.id != 0) UnloadRenderTexture(boardLayer);
+    CloseWindow();
+}
+
+// =================== SPECTATOR GRID ===========
+// --grid N: N all-AI games side by side, one scaled-down board per tile,
+// each restarted with the next dice stream of the seed when it ends.
+// Nothing is logged.
+//
+// The static board is the cached board layer at tile size, drawn once per
+// tile (one texture, so raylib batches the tiles). Pieces, the ring on the
+// piece just moved and the dice are sprites, rasterized once into an atlas
+// by the same draw helpers as the big board, and every sprite of every
+// tile goes out in one textured-quad pass.
+template <class V>
+struct GridBoard {
+    BasicGameState<V> s;
+    CounterRng dice, ai;
+    uint64_t index = 0;                     // dice stream (gameSeed, index)
+    uint32_t plies = 0;
+    float wait = 0.0f;                      // until the next turn, or the restart once over
+    float slide = GRID_SLIDE;               // since the last move
+    int8_t mover = -1, piece = PASS;        // last turn
+    uint8_t roll = 0;
+    Vector2 from{};                         // moved piece's previous cell centre, in cells
+};
+
+template <class V> GridBoard<V> gridBoards[GRID_MAX];
+int gridCount = 0;
+int gridCursor = 0;                         // first board served next frame
+uint64_t gridNextGame = 0, gridFinished = 0, gridTurns = 0;
+
+// Atlas cells, SPRITE px square: a piece per arm colour, the ring, dice faces 1..6.
+enum SpriteId { SPR_PIECE = 0, SPR_RING = SPR_PIECE + CROSS_ARMS, SPR_DICE = SPR_RING + 1, SPR_COUNT = SPR_DICE + 6 };
+static const int SPRITE = 64, ATLAS_COLS = 4;
+static const float SPRITE_R = 30.0f;        // piece and ring radius; the rest is margin for filtering
+RenderTexture2D spriteAtlas{};
+
+void BuildSpriteAtlas() {
+    spriteAtlas = LoadRenderTexture(ATLAS_COLS * SPRITE, (SPR_COUNT + ATLAS_COLS - 1) / ATLAS_COLS * SPRITE);
+    auto centre = [](int id) {
+        return Vector2{ (float)(id % ATLAS_COLS * SPRITE + SPRITE / 2), (float)(id / ATLAS_COLS * SPRITE + SPRITE / 2) };
+    };
+    BeginTextureMode(spriteAtlas);
+    ClearBackground(BLANK);
+    for (int arm = 0; arm < CROSS_ARMS; ++arm) {
+        Vector2 c = centre(SPR_PIECE + arm);
+        DrawCircleV(c, SPRITE_R, ARM_COLOR[arm]);
+        DrawStarOutline((int)c.x, (int)c.y, SPRITE_R * 0.6f, WHITE, 3.0f);   // 1 px would vanish when scaled down
+    }
+    DrawRing(centre(SPR_RING), SPRITE_R - 5.0f, SPRITE_R, 0.0f, 360.0f, 48, WHITE);
+    for (int face = 1; face <= 6; ++face) {
+        Vector2 c = centre(SPR_DICE + face - 1);
+        DrawDiceFace(face, c.x - SPRITE_R, c.y - SPRITE_R, 2 * SPRITE_R, WHITE, BLACK);
+    }
+    EndTextureMode();
+    GenTextureMipmaps(&spriteAtlas.texture);
+    SetTextureFilter(spriteAtlas.texture, TEXTURE_FILTER_TRILINEAR);
+}
+
+// One atlas quad centred on `c`, drawn `radius` px for SPRITE_R. Only
+// between rlBegin(RL_QUADS) and rlEnd(); render textures are stored upside
+// down, so v runs from the bottom.
+void SpriteQuad(int id, Vector2 c, float radius, Color tint) {
+    const float tw = (float)spriteAtlas.texture.width, th = (float)spriteAtlas.texture.height;
+    const float half = radius * (SPRITE / 2) / SPRITE_R;
+    float u0 = (float)(id % ATLAS_COLS * SPRITE) / tw, u1 = u0 + SPRITE / tw;
+    float v0 = 1.0f - (float)(id / ATLAS_COLS * SPRITE) / th, v1 = v0 - SPRITE / th;
+    rlColor4ub(tint.r, tint.g, tint.b, tint.a);
+    rlTexCoord2f(u0, v0); rlVertex2f(c.x - half, c.y - half);
+    rlTexCoord2f(u0, v1); rlVertex2f(c.x - half, c.y + half);
+    rlTexCoord2f(u1, v1); rlVertex2f(c.x + half, c.y + half);
+    rlTexCoord2f(u1, v0); rlVertex2f(c.x + half, c.y - half);
+}
+
+template <class V>
+void GridStartGame(GridBoard<V>& b) {
+    b.index = gridNextGame++;
+    b.s = NewGame<V>();
+    b.dice = CounterRng(gameSeed, b.index, STREAM_DICE);
+    b.ai = CounterRng(gameSeed, b.index, STREAM_AI);
+    b.plies = 0;
+    b.mover = -1; b.piece = PASS; b.roll = 0;
+    b.slide = GRID_SLIDE;
+}
+
+template <class V>
+bool GridOver(const GridBoard<V>& b) { return IsGameOver(b.s) || b.plies >= MAX_PLIES; }
+
+template <class V>
+void GridTurn(GridBoard<V>& b) {
+    int d = b.dice.RollDice();
+    MoveList legal = LegalMoves(b.s, d);
+    Move mv = legal.empty() ? Move{ (int8_t)PASS, (uint8_t)d } : PickPolicyMove(aiPolicy, b.s, legal, b.ai);
+    b.mover = (int8_t)b.s.current; b.piece = mv.piece; b.roll = (uint8_t)d;
+    if (mv.piece != PASS) {
+        Vec2i c = PieceCell(b.s, b.mover, mv.piece);
+        b.from = { c.c + 0.5f, c.r + 0.5f };
+        b.slide = 0.0f;
+    }
+    b.s = ApplyMove(b.s, mv);
+    ++b.plies; ++gridTurns;
+    if (GridOver(b)) { ++gridFinished; b.wait = simSpeed == SPEED_TURBO ? GRID_HOLD / 8 : GRID_HOLD; }
+}
+
+// Each board plays a turn every GRID_TURN_TIME (turbo: turboTurnsPerFrame
+// a frame). Turns are played on the frame thread until GRID_AI_MS is spent;
+// boards still due then go first next frame, so a slow policy slows the
+// games rather than the frame rate.
+template <class V>
+void GridAdvance(float dt) {
+    PROFILE_SCOPE(PHASE_NAME[PH_AI]);
+    const bool turbo = simSpeed == SPEED_TURBO;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int k = 0; k < gridCount; ++k) { gridBoards<V>[k].wait -= dt; gridBoards<V>[k].slide += dt; }
+    for (int n = 0; n < gridCount; ++n) {
+        int k = (gridCursor + n) % gridCount;
+        GridBoard<V>& b = gridBoards<V>[k];
+        if (b.wait > 0.0f) continue;
+        if (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() > GRID_AI_MS) {
+            gridCursor = k;
+            return;
+        }
+        if (GridOver(b)) { GridStartGame(b); b.wait = turbo ? 0.0f : GRID_TURN_TIME; continue; }
+        for (int t = 0; t < (turbo ? turboTurnsPerFrame : 1) && !GridOver(b); ++t) GridTurn(b);
+        if (!GridOver(b)) b.wait = turbo ? 0.0f : GRID_TURN_TIME;   // a late board does not catch up
+    }
+}
+
+// The most columns that still leave the largest square tiles.
+struct GridLayout { int cols, tile; float x0, y0; };
+
+GridLayout LayoutGrid(int n) {
+    int w = GetScreenWidth(), h = GetScreenHeight() - GRID_HEADER;
+    GridLayout l{ 1, 0, 0.0f, 0.0f };
+    for (int cols = 1; cols <= n; ++cols) {
+        int rows = (n + cols - 1) / cols, tile = std::min(w / cols, h / rows);
+        if (tile > l.tile) { l.cols = cols; l.tile = tile; }
+    }
+    l.tile = std::max(l.tile, GRID_GAP + BOARD_N);
+    int rows = (n + l.cols - 1) / l.cols;
+    l.x0 = (w - l.cols * l.tile + GRID_GAP) / 2.0f;
+    l.y0 = GRID_HEADER + (h - rows * l.tile + GRID_GAP) / 2.0f;
+    return l;
+}
+
+Vector2 GridOrigin(const GridLayout& l, int k) {
+    return { l.x0 + (float)(k % l.cols * l.tile), l.y0 + (float)(k / l.cols * l.tile) };
+}
+
+// Every piece, ring and die of every board in one quad pass over the atlas.
+template <class V>
+void DrawGridSprites(const GridLayout& l) {
+    const float cell = (float)(l.tile - GRID_GAP) / BOARD_N;
+    const float rad = cell * 14.0f / CELL;
+    rlCheckRenderBatchLimit(4 * gridCount * (V::PLAYERS * NUM_PIECES + 2));
+    rlSetTexture(spriteAtlas.texture.id);
+    rlBegin(RL_QUADS);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+    for (int k = 0; k < gridCount; ++k) {
+        const GridBoard<V>& b = gridBoards<V>[k];
+        Vector2 o = GridOrigin(l, k);
+        uint8_t cellCount[BOARD_N][BOARD_N] = {}, cellDrawn[BOARD_N][BOARD_N] = {};
+        for (int p = 0; p < V::PLAYERS; ++p)
+            for (int i = 0; i < NUM_PIECES; ++i) { Vec2i v = PieceCell(b.s, p, i); cellCount[v.r][v.c]++; }
+
+        for (int p = 0; p < V::PLAYERS; ++p) {
+            for (int i = 0; i < NUM_PIECES; ++i) {
+                Vec2i v = PieceCell(b.s, p, i);
+                int count = cellCount[v.r][v.c], order = cellDrawn[v.r][v.c]++;
+                float off = (order - (count - 1) / 2.0f) * rad * 0.7f;
+                Vector2 at{ v.c + 0.5f, v.r + 0.5f };
+                bool moved = p == b.mover && i == b.piece;
+                if (moved && b.slide < GRID_SLIDE && simSpeed != SPEED_TURBO) {
+                    float t = EaseOutCubic(b.slide / GRID_SLIDE);
+                    at = { LerpF(b.from.x, at.x, t), LerpF(b.from.y, at.y, t) };
                 }
+                Vector2 pos{ o.x + at.x * cell + off, o.y + at.y * cell - off };
+                SpriteQuad(SPR_PIECE + players[p].arm, pos, rad, WHITE);
+                if (moved && !GridOver(b))
+                    SpriteQuad(SPR_RING, pos, rad * (1.35f + 0.15f * sinf(globalTime * 6.0f)), players[p].color);
             }
         }
+        if (b.roll)     // in the colour of the seat that threw it
+            SpriteQuad(SPR_DICE + b.roll - 1, { o.x + 7.5f * cell, o.y + 7.5f * cell }, cell * 0.9f,
+                players[b.mover].color);
+    }
+    rlEnd();
+    rlSetTexture(0);
+}
 
-        // Sidebar
-        DrawRectangle(BOARD_W, 0, SIDEBAR_W, SCR_H, LIGHTGRAY);
-        DrawText("Ludo", BOARD_W + 30, 24, 36, BLACK);
-        DrawText(TextFormat("Turn: %s",
-            currentPlayer == 3 ? "You (RED)" :
-            currentPlayer == 2 ? "Green" :
-            currentPlayer == 1 ? "Blue" : "Yellow"),
-            BOARD_W + 30, 74, 22, BLACK);
-
-        // Dice + roll button
-        Rectangle diceBox = { BOARD_W + 40, SCR_H - 100, 60, 60 };
-        DrawDiceFace(diceRollingAnim ? diceFaceDuring : (hasRolled ? rollResult : 0),
-            diceBox.x, diceBox.y, diceBox.width, WHITE, BLACK);
-
-        Color btnColor = ColorAlpha(GREEN, diceRollingAnim ? 0.9f : (hasRolled ? 0.55f : 0.85f));
-        DrawRectangleRounded(rollBtn, 0.18f, 6, btnColor);
-        DrawRectangleRoundedLines(rollBtn, 0.18f, 6, BLACK);
-        DrawText(hasRolled ? "Select Piece" : "Roll Dice",
-            rollBtn.x + 20, rollBtn.y + 18, 24, BLACK);
-
-        // Finish order
-        int y = 140;
-        DrawText("Finish Order:", BOARD_W + 30, y, 20, BLACK); y += 28;
-        for (int place = 1; place <= 4; ++place) {
-            for (int p = 0; p < 4; ++p) if (players[p].finishPlace == place) {
-                DrawText(TextFormat("%d) %s", place,
-                    p == 3 ? "You (RED)" :
-                    p == 2 ? "Green" :
-                    p == 1 ? "Blue" : "Yellow"),
-                    BOARD_W + 40, y, 18, players[p].color);
-                y += 22;
-            }
+// Game numbers, results over finished boards and the status line.
+template <class V>
+void DrawGridLabels(const GridLayout& l) {
+    const int board = l.tile - GRID_GAP, font = std::max(10, board / 14);
+    for (int k = 0; k < gridCount; ++k) {
+        const GridBoard<V>& b = gridBoards<V>[k];
+        Vector2 o = GridOrigin(l, k);
+        if (board >= 96) DrawText(TextFormat("#%llu", (unsigned long long)b.index), (int)o.x + 3, (int)o.y + 2, font, BLACK);
+        if (!GridOver(b)) continue;
+        DrawRectangle((int)o.x, (int)o.y, board, board, ColorAlpha(BLACK, 0.45f));
+        int winner = -1;
+        for (int p = 0; p < V::PLAYERS; ++p) if (b.s.finishPlace[p] == 1) winner = p;
+        const char* text = winner < 0 ? "unfinished" : TextFormat("%s wins", ARM_NAME[players[winner].arm]);
+        DrawText(text, (int)o.x + (board - MeasureText(text, font)) / 2, (int)o.y + (board - font) / 2, font,
+            winner < 0 ? RAYWHITE : players[winner].color);
+    }
+    DrawText(TextFormat("%d games  seed %llu  finished %llu  turns %llu  %d FPS   T: turbo  P: profiler",
+        gridCount, (unsigned long long)gameSeed, (unsigned long long)gridFinished,
+        (unsigned long long)gridTurns, GetFPS()), 8, 6, 16, simSpeed == SPEED_TURBO ? GOLD : RAYWHITE);
+}
+
+template <class V>
+void RunGrid(int boards) {
+    SetConfigFlags(FLAG_WINDOW_RESIZABLE);
+    InitWindow(SCR_W, SCR_H, "Ludo spectator grid");
+    SetTargetFPS(60);
+
+    allAi = true;
+    BuildBoardAndPaths<V>();
+    SeatPlayers<V>();
+    BuildSpriteAtlas();
+    gridCount = boards;
+    for (int k = 0; k < boards; ++k) {
+        GridStartGame(gridBoards<V>[k]);
+        gridBoards<V>[k].wait = GRID_TURN_TIME * k / boards;      // staggered, not all on one frame
+    }
+
+    while (!WindowShouldClose()) {
+        PROFILE_SCOPE(PHASE_NAME[PH_FRAME]);
+        AllocScope frameScope;
+        float dt = GetFrameTime();
+        globalTime += dt;
+
+        if (IsKeyPressed(KEY_T)) simSpeed = (simSpeed == SPEED_TURBO) ? SPEED_NORMAL : SPEED_TURBO;
+        if (IsKeyPressed(KEY_P)) profilerOverlay = !profilerOverlay;
+        if (IsKeyPressed(KEY_D)) lastTraceEvents = WriteChromeTrace(Profiler(), TRACE_OUT);
+        GridAdvance<V>(dt);
+
+        GridLayout l = LayoutGrid(gridCount);
+        {
+            PROFILE_SCOPE(PHASE_NAME[PH_BOARD]);
+            EnsureBoardLayer(l.tile - GRID_GAP);
+            BeginDrawing();
+            ClearBackground(DARKGRAY);
+            Rectangle src{ 0, 0, (float)boardLayer.texture.width, -(float)boardLayer.texture.height };
+            for (int k = 0; k < gridCount; ++k) DrawTextureRec(boardLayer.texture, src, GridOrigin(l, k), WHITE);
+        }
+        {
+            PROFILE_SCOPE(PHASE_NAME[PH_PIECES]);
+            DrawGridSprites<V>(l);
+        }
+        {
+            PROFILE_SCOPE(PHASE_NAME[PH_SIDEBAR]);
+            DrawGridLabels<V>(l);
+            if (profilerOverlay) DrawProfilerOverlay();
+        }
+        {
+            PROFILE_SCOPE(PHASE_NAME[PH_PRESENT]);
+            EndDrawing();
         }
 
-        EndDrawing();
+        frameAllocs = frameScope.Count();
+        if (++frameNo > ALLOC_WARMUP_FRAMES && frameAllocs > steadyAllocPeak) steadyAllocPeak = frameAllocs;
     }
 
+    UnloadRenderTexture(spriteAtlas);
+    if (boardLayer.id != 0) UnloadRenderTexture(boardLayer);
     CloseWindow();
+}
+
+// =================== MAIN =====================
+//   ludo [--seed N] [--all-ai] [--turbo N] [--ai POLICY] [--players 2|4]
+//                                   play; 4-player games stream to ludo_replay.bin
+//   ludo --resume [--players 2|4]   continue the game saved in ludo_save.bin (not logged)
+//   ludo --replay FILE [--game K]   step through a logged game
+//   ludo --headless N               N all-AI games without a window
+//   ludo --grid N [--ai POLICY]     watch N (up to 64) all-AI games at once; greedy by default
+int main(int argc, char** argv) {
+    gameSeed = (uint64_t)time(nullptr);
+    const char* replayPath = nullptr;
+    uint64_t replayIndex = 0, headlessGames = 0;
+    int gridGames = 0;
+    bool policyGiven = false;
+    aiPolicy.kind = POLICY_SEARCH;
+    aiPolicy.search = { 32, 40 };               // deepen until 40 ms are spent (AI_THINK_MS at normal speed)
+    for (int i = 1; i < argc; ++i) {
+        const char* val = (i + 1 < argc) ? argv[i + 1] : "";
+        if (!strcmp(argv[i], "--all-ai")) allAi = true;
+        else if (!strcmp(argv[i], "--resume")) resumeGame = true;
+        else if (!strcmp(argv[i], "--seed")) { gameSeed = strtoull(val, nullptr, 10); ++i; }
+        else if (!strcmp(argv[i], "--replay")) { replayPath = val; ++i; }
+        else if (!strcmp(argv[i], "--game")) { replayIndex = strtoull(val, nullptr, 10); ++i; }
+        else if (!strcmp(argv[i], "--headless")) { headlessGames = strtoull(val, nullptr, 10); ++i; }
+        else if (!strcmp(argv[i], "--grid")) { gridGames = atoi(val); ++i; }
+        else if (!strcmp(argv[i], "--players")) { numPlayers = atoi(val); ++i; }
+        else if (!strcmp(argv[i], "--turbo")) { simSpeed = SPEED_TURBO; turboTurnsPerFrame = std::max(1, atoi(val)); ++i; }
+        else if (!strcmp(argv[i], "--ai")) {
+            if (!ParsePolicy(val, aiPolicy)) { fprintf(stderr, "unknown policy '%s'\n", val); return 2; }
+            policyGiven = true;
+            ++i;
+        }
+    }
+    if (numPlayers != 2 && numPlayers != 4) { fprintf(stderr, "--players takes 2 or 4\n"); return 2; }
+    if (gridGames < 0 || gridGames > GRID_MAX) { fprintf(stderr, "--grid takes 1 to %d games\n", GRID_MAX); return 2; }
+    if (gridGames > 0 && !policyGiven) aiPolicy = Policy();    // greedy: 64 boards cannot each search
+    if (raceTable.Open(TABLEBASE_FILE)) aiPolicy.tablebase = &raceTable;
+    if (gridGames > 0) {
+        if (numPlayers == 2) RunGrid<DuelBoard>(gridGames);
+        else RunGrid<ClassicBoard>(gridGames);
+        return 0;
+    }
+    if (replayPath) {
+        numPlayers = NUM_PLAYERS;               // the replay format is four-seat only
+        if (!LoadReplay(replayPath, replayIndex)) { fprintf(stderr, "cannot read game %llu from %s\n",
+            (unsigned long long)replayIndex, replayPath); return 1; }
+        replayMode = true;
+        gameSeed = replayGame.header->seed;
+        gameIndex = replayGame.header->gameIndex;
+    }
+    else if (numPlayers == NUM_PLAYERS && !resumeGame && !replayOut.Open(REPLAY_OUT)) {
+        fprintf(stderr, "warning: cannot write %s, game will not be logged\n", REPLAY_OUT);
+    }
+    if (headlessGames > 0 && !replayMode) {
+        int rc = numPlayers == 2 ? RunHeadless<DuelBoard>(headlessGames) : RunHeadless<ClassicBoard>(headlessGames);
+        replayOut.Close();
+        return rc;
+    }
+
+    if (numPlayers == 2) RunWindow<DuelBoard>();
+    else RunWindow<ClassicBoard>();
+    replayOut.Close();
     return 0;
 }
@@ -0,0 +1,131 @@
+#include "LudoAi.h"
+#include "LudoReplay.h"
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+// =================== POLICIES ===================
+template <class V>
+Move PickGreedyMove(const BasicGameState<V>& s, const MoveList& legal, const AiWeights& w, CounterRng& rng) {
+    Move pick = legal.m[0];
+    int best = -999;
+    int p = s.current;
+    for (const Move& mv : legal) {
+        int score = 0;
+        int sq = s.sq[p][mv.piece];
+        uint8_t f = StepFor<V>(p, sq, mv.dice).flags;
+        if (f & STEP_SPAWN) score += w.spawn;
+        if (IsInFinal<V>(sq) && (f & STEP_COMPLETES)) score += w.finish;
+        if (IsOnLoop<V>(sq) && (f & STEP_CAPTURES)) score += w.capture; // possible capture
+        if (w.jitter > 0) score += (int)rng.Below((uint32_t)w.jitter);
+        if (score > best) { best = score; pick = mv; }
+    }
+    return pick;
+}
+
+// One search (and transposition table) per thread and variant, reused across games.
+template <class V>
+static BasicExpectiSearch<V>& ThreadSearch(size_t ttMegabytes) {
+    thread_local std::unique_ptr<BasicExpectiSearch<V>> search;
+    if (!search || search->TableMegabytes() != ttMegabytes) search.reset(new BasicExpectiSearch<V>(ttMegabytes));
+    return *search;
+}
+
+static bool TablebaseMove(const RaceTablebase* tb, const GameState& s, const MoveList& legal, Move& out) {
+    return tb && tb->PickMove(s, legal, out);
+}
+
+template <class V>
+static bool TablebaseMove(const RaceTablebase*, const BasicGameState<V>&, const MoveList&, Move&) { return false; }
+
+template <class V>
+Move PickPolicyMove(const Policy& policy, const BasicGameState<V>& s, const MoveList& legal, CounterRng& rng) {
+    Move mv;
+    bool thinking = policy.kind == POLICY_GREEDY || policy.kind == POLICY_SEARCH;
+    if (thinking && TablebaseMove(policy.tablebase, s, legal, mv)) return mv;
+    switch (policy.kind) {
+    case POLICY_RANDOM: return legal.m[rng.Below((uint32_t)legal.count)];
+    case POLICY_FIRST:  return legal.m[0];
+    case POLICY_SEARCH: {
+        BasicExpectiSearch<V>& search = ThreadSearch<V>(policy.ttMegabytes);
+        search.SetTablebase(policy.tablebase);
+        return search.Pick(s, legal, policy.search);
+    }
+    default:            return PickGreedyMove(s, legal, policy.weights, rng);
+    }
+}
+
+bool ParsePolicy(const char* name, Policy& out) {
+    out = Policy();
+    if (std::strcmp(name, "random") == 0) { out.kind = POLICY_RANDOM; return true; }
+    if (std::strcmp(name, "first") == 0) { out.kind = POLICY_FIRST; return true; }
+    if (std::strncmp(name, "greedy", 6) == 0) {
+        out.kind = POLICY_GREEDY;
+        if (name[6] == '\0') return true;
+        AiWeights& w = out.weights;
+        return std::sscanf(name + 6, ":%d:%d:%d", &w.spawn, &w.finish, &w.capture) == 3;
+    }
+    if (std::strncmp(name, "search", 6) == 0) {
+        out.kind = POLICY_SEARCH;
+        if (name[6] == '\0') return true;
+        int depth = 0, ms = 0;
+        int n = std::sscanf(name + 6, ":%d:%d", &depth, &ms);
+        if (n < 1 || depth < 1) return false;
+        out.search.maxDepth = depth;
+        out.search.timeBudgetMs = (n == 2) ? ms : 0;
+        return true;
+    }
+    return false;
+}
+
+const char* PolicyName(PolicyKind kind) {
+    switch (kind) {
+    case POLICY_RANDOM: return "random";
+    case POLICY_FIRST:  return "first";
+    case POLICY_SEARCH: return "search";
+    default:            return "greedy";
+    }
+}
+
+// =================== GAME DRIVER ================
+// Replays use the classic layout; other variants are never logged.
+static void RecordTurn(ReplayEncoder* rec, int mover, Move mv, const GameState& after) {
+    if (rec) rec->Record(mover, mv, after);
+}
+
+template <class V>
+static void RecordTurn(ReplayEncoder*, int, Move, const BasicGameState<V>&) {}
+
+template <class V>
+GameResult PlayGame(const Policy seats[V::PLAYERS], uint64_t seed, uint64_t gameIndex,
+                    ReplayEncoder* rec) {
+    CounterRng dice(seed, gameIndex, STREAM_DICE);
+    CounterRng ai(seed, gameIndex, STREAM_AI);
+    BasicGameState<V> s = NewGame<V>();
+    GameResult r = {};
+    if (!std::is_same<V, ClassicBoard>::value) rec = nullptr;
+    if (rec) rec->BeginGame(seed, gameIndex);
+    while (!IsGameOver(s) && r.plies < MAX_PLIES) {
+        int d = dice.RollDice();
+        MoveList legal = LegalMoves(s, d);
+        Move mv = legal.empty() ? Move{ (int8_t)PASS, (uint8_t)d }
+                                : PickPolicyMove(seats[s.current], s, legal, ai);
+        int mover = s.current;
+        s = ApplyMove(s, mv);
+        RecordTurn(rec, mover, mv, s);
+        ++r.plies;
+    }
+    if (rec) rec->EndGame();
+    std::memcpy(r.finishPlace, s.finishPlace, sizeof(s.finishPlace));
+    return r;
+}
+
+// =================== VARIANTS ===================
+#define LUDO_INSTANTIATE_AI(V)                                                                          \
+    template Move PickGreedyMove<V>(const BasicGameState<V>&, const MoveList&, const AiWeights&, CounterRng&); \
+    template Move PickPolicyMove<V>(const Policy&, const BasicGameState<V>&, const MoveList&, CounterRng&);   \
+    template GameResult PlayGame<V>(const Policy*, uint64_t, uint64_t, ReplayEncoder*);
+
+LUDO_INSTANTIATE_AI(ClassicBoard)
+LUDO_INSTANTIATE_AI(DuelBoard)
+LUDO_INSTANTIATE_AI(SixBoard)
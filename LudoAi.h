@@ -0,0 +1,55 @@
+#pragma once
+// Move-picking policies and a headless full-game driver on top of the engine.
+// Templates over the board variant, instantiated for every variant in
+// LudoAi.cpp; the race tablebase and replay logging are classic-only and
+// ignored elsewhere.
+#include "LudoEngine.h"
+#include "LudoRandom.h"
+#include "LudoSearch.h"
+
+enum PolicyKind : uint8_t {
+    POLICY_RANDOM,      // uniform over legal moves
+    POLICY_FIRST,       // lowest legal piece index
+    POLICY_GREEDY,      // the original "Simple AI" scoring
+    POLICY_SEARCH,      // expectiminimax (LudoSearch.h)
+};
+
+// Scores used by the greedy policy (the constants of the original AI).
+struct AiWeights {
+    int spawn = 10;       // leave base on a six
+    int finish = 50;      // land exactly on the home stop
+    int capture = 20;     // land on a non-safe loop square ("possible capture")
+    int jitter = 3;       // random 0..jitter-1 tie-break
+};
+
+struct Policy {
+    PolicyKind kind = POLICY_GREEDY;
+    AiWeights weights;
+    SearchLimits search{ 3, 0 };       // POLICY_SEARCH: depth 3, no clock
+    size_t ttMegabytes = 16;           // POLICY_SEARCH: table size per thread
+    const RaceTablebase* tablebase = nullptr;   // greedy/search: exact race endings
+};
+
+struct GameResult {
+    uint8_t  finishPlace[MAX_SEATS];    // the variant's first PLAYERS entries
+    uint32_t plies;       // rolls taken, passes included
+};
+
+static const uint32_t MAX_PLIES = 20000;   // safety net; real games take a few hundred
+
+template <class V>
+Move PickGreedyMove(const BasicGameState<V>& s, const MoveList& legal, const AiWeights& w, CounterRng& rng);
+template <class V>
+Move PickPolicyMove(const Policy& policy, const BasicGameState<V>& s, const MoveList& legal, CounterRng& rng);
+// random | first | greedy[:spawn:finish:capture] | search[:depth[:ms]]
+bool ParsePolicy(const char* name, Policy& out);
+const char* PolicyName(PolicyKind kind);
+
+struct ReplayEncoder;
+
+// Plays one complete game. The dice come from CounterRng(seed, gameIndex),
+// so the result depends only on the seats, seed and game index. With
+// `rec`, every turn is appended to the replay buffer.
+template <class V = ClassicBoard>
+GameResult PlayGame(const Policy seats[V::PLAYERS], uint64_t seed, uint64_t gameIndex,
+                    ReplayEncoder* rec = nullptr);
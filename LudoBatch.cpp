@@ -0,0 +1,302 @@
+#include "LudoBatch.h"
+#include <climits>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+static_assert(NUM_PLAYERS == 4, "seat rotation uses & 3");
+
+static const int32_t NO_SCORE = INT32_MIN;   // illegal move
+static const int32_t GREEDY_FLOOR = -999;    // PickGreedyMove's starting best; ties keep the first legal move
+
+GameBatch::GameBatch(int lanes_) {
+    lanes = (std::max(lanes_, 1) + BATCH_LANES - 1) / BATCH_LANES * BATCH_LANES;
+    sq.assign((size_t)NUM_PLAYERS * NUM_PIECES * lanes, IN_BASE);
+    finishPlace.assign((size_t)NUM_PLAYERS * lanes, 0);
+    current.assign(lanes, 0); nextPlace.assign(lanes, 0); dice.assign(lanes, 0);
+    plies.assign(lanes, 0); heroSeat.assign(lanes, 0);
+    from.assign((size_t)NUM_PIECES * lanes, 0);
+    dest.assign((size_t)NUM_PIECES * lanes, -1);
+    jitter.assign((size_t)NUM_PIECES * lanes, 0);
+    gameOf.assign(lanes, -1);
+    diceRng.resize(lanes); aiRng.resize(lanes);
+}
+
+bool GameBatch::SimdCompiled() {
+#if defined(__AVX2__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+static bool LaneActive(int32_t nextPlace, int32_t plies) {
+    return nextPlace <= NUM_PLAYERS && plies < (int32_t)MAX_PLIES;
+}
+
+// =================== LANES ======================
+// NewGame() in SoA form; game < 0 parks the lane as an already finished game.
+void GameBatch::StartGame(int l, uint64_t seed, uint64_t game) {
+    for (int k = 0; k < NUM_PLAYERS * NUM_PIECES; ++k) sq[(size_t)k * lanes + l] = IN_BASE;
+    for (int p = 0; p < NUM_PLAYERS; ++p) finishPlace[(size_t)p * lanes + l] = 0;
+    current[l] = FIRST_PLAYER;
+    nextPlace[l] = 1;
+    plies[l] = 0;
+    heroSeat[l] = (int32_t)(game % NUM_PLAYERS);
+    gameOf[l] = (int64_t)game;
+    diceRng[l] = CounterRng(seed, game, STREAM_DICE);
+    aiRng[l] = CounterRng(seed, game, STREAM_AI);
+}
+
+void GameBatch::RollDice() {
+    for (int l = 0; l < lanes; ++l)
+        dice[l] = LaneActive(nextPlace[l], plies[l]) ? diceRng[l].RollDice() : 0;
+}
+
+// Greedy tie-break draws, one per legal move in piece order (PickGreedyMove).
+void GameBatch::DrawJitter(const BatchMatchup& m) {
+    for (int l = 0; l < lanes; ++l) {
+        const AiWeights& w = current[l] == heroSeat[l] ? m.hero : m.field;
+        for (int i = 0; i < NUM_PIECES; ++i) {
+            size_t at = (size_t)i * lanes + l;
+            jitter[at] = (w.jitter > 0 && dest[at] >= 0) ? (int32_t)aiRng[l].Below((uint32_t)w.jitter) : 0;
+        }
+    }
+}
+
+// =================== SCALAR KERNELS =============
+void GameBatch::LegalScalar() {
+    for (int l = 0; l < lanes; ++l) {
+        bool active = LaneActive(nextPlace[l], plies[l]);
+        int p = current[l], d = dice[l];
+        for (int i = 0; i < NUM_PIECES; ++i) {
+            int s = sq[(size_t)(p * NUM_PIECES + i) * lanes + l];
+            int t = (s == IN_BASE) ? (d == 6 ? START_INDEX[p] : -1) : (s + d <= HOME_STOP ? s + d : -1);
+            from[(size_t)i * lanes + l] = s;
+            dest[(size_t)i * lanes + l] = active ? t : -1;
+        }
+    }
+}
+
+void GameBatch::ApplyScalar(const BatchMatchup& m) {
+    for (int l = 0; l < lanes; ++l) {
+        if (!LaneActive(nextPlace[l], plies[l])) continue;
+        int p = current[l];
+        const AiWeights& w = p == heroSeat[l] ? m.hero : m.field;
+
+        // Greedy pick: first piece with the highest score.
+        int32_t best = GREEDY_FLOOR;
+        int pick = -1, to = -1, firstPick = -1, firstTo = -1;
+        for (int i = 0; i < NUM_PIECES; ++i) {
+            size_t at = (size_t)i * lanes + l;
+            int s = from[at], t = dest[at];
+            if (t < 0) continue;
+            if (firstPick < 0) { firstPick = i; firstTo = t; }
+            int32_t score = jitter[at];
+            if (s == IN_BASE) score += w.spawn;
+            if (IsInFinal(s) && t == HOME_STOP) score += w.finish;
+            if (IsOnLoop(s) && IsOnLoop(t) && !IsSafeSquare(t)) score += w.capture;
+            if (score > best) { best = score; pick = i; to = t; }
+        }
+        if (pick < 0) { pick = firstPick; to = firstTo; }
+
+        int32_t& np = nextPlace[l];
+        auto fp = [&](int seat) -> int32_t& { return finishPlace[(size_t)seat * lanes + l]; };
+        if (pick >= 0) {
+            sq[(size_t)(p * NUM_PIECES + pick) * lanes + l] = to;
+            if (IsOnLoop(to) && !IsSafeSquare(to))
+                for (int op = 0; op < NUM_PLAYERS; ++op) {
+                    if (op == p) continue;
+                    for (int i = 0; i < NUM_PIECES; ++i) {
+                        int32_t& v = sq[(size_t)(op * NUM_PIECES + i) * lanes + l];
+                        if (v == to) v = IN_BASE;
+                    }
+                }
+            bool allHome = true;
+            for (int i = 0; i < NUM_PIECES; ++i) allHome &= sq[(size_t)(p * NUM_PIECES + i) * lanes + l] == HOME_STOP;
+            if (to == HOME_STOP && allHome && fp(p) == 0) {
+                fp(p) = np++;
+                if (np == NUM_PLAYERS)
+                    for (int op = 0; op < NUM_PLAYERS; ++op)
+                        if (fp(op) == 0) fp(op) = np++;
+            }
+        }
+        plies[l]++;
+        if (np > NUM_PLAYERS) continue;             // game over: the turn stays put
+        if (pick >= 0 && dice[l] == 6 && fp(p) == 0) continue;   // a six rolls again
+        int nxt = (p + 1) & 3;
+        while (fp(nxt) != 0) nxt = (nxt + 1) & 3;
+        current[l] = nxt;
+    }
+}
+
+// =================== AVX2 KERNELS ===============
+#if defined(__AVX2__)
+static inline __m256i Load(const int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+static inline void Store(int32_t* p, __m256i v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+static inline __m256i Set(int32_t v) { return _mm256_set1_epi32(v); }
+static inline __m256i Blend(__m256i a, __m256i b, __m256i mask) { return _mm256_blendv_epi8(a, b, mask); }
+static inline __m256i And(__m256i a, __m256i b) { return _mm256_and_si256(a, b); }
+static inline __m256i AndNot(__m256i notA, __m256i b) { return _mm256_andnot_si256(notA, b); }
+static inline __m256i Eq(__m256i a, __m256i b) { return _mm256_cmpeq_epi32(a, b); }
+static inline __m256i Gt(__m256i a, __m256i b) { return _mm256_cmpgt_epi32(a, b); }
+
+// All-ones where square `s` is a safe loop square. Shift counts of 32 and
+// up (including negative squares) give 0, so off-loop squares are unsafe.
+static inline __m256i SafeLanes(__m256i s) {
+    __m256i lo = _mm256_srlv_epi32(Set((int32_t)(uint32_t)SAFE_LOOP_MASK), s);
+    __m256i hi = _mm256_srlv_epi32(Set((int32_t)(uint32_t)(SAFE_LOOP_MASK >> 32)), _mm256_sub_epi32(s, Set(32)));
+    return Eq(And(_mm256_or_si256(lo, hi), Set(1)), Set(1));
+}
+
+// v[seat] of each lane's `seat`.
+static inline __m256i BySeat(const __m256i v[NUM_PLAYERS], __m256i seat) {
+    __m256i r = v[0];
+    for (int p = 1; p < NUM_PLAYERS; ++p) r = Blend(r, v[p], Eq(seat, Set(p)));
+    return r;
+}
+
+static inline __m256i ActiveLanes(__m256i nextPlace, __m256i plies) {
+    return And(Gt(Set(NUM_PLAYERS + 1), nextPlace), Gt(Set((int32_t)MAX_PLIES), plies));
+}
+
+void GameBatch::LegalAvx2() {
+    const __m256i startTbl = _mm256_setr_epi32(START_INDEX[0], START_INDEX[1], START_INDEX[2], START_INDEX[3], 0, 0, 0, 0);
+    for (int l = 0; l < lanes; l += BATCH_LANES) {
+        __m256i cur = Load(&current[l]), d = Load(&dice[l]);
+        __m256i active = ActiveLanes(Load(&nextPlace[l]), Load(&plies[l]));
+        __m256i start = _mm256_permutevar8x32_epi32(startTbl, cur);
+        __m256i spawnRoll = Eq(d, Set(6));
+        for (int i = 0; i < NUM_PIECES; ++i) {
+            __m256i s = Load(&sq[(size_t)i * lanes + l]);
+            for (int p = 1; p < NUM_PLAYERS; ++p)
+                s = Blend(s, Load(&sq[(size_t)(p * NUM_PIECES + i) * lanes + l]), Eq(cur, Set(p)));
+            __m256i t = _mm256_add_epi32(s, d);
+            __m256i inBase = Eq(s, Set(IN_BASE));
+            __m256i to = Blend(Set(-1), t, AndNot(inBase, Gt(Set(HOME_STOP + 1), t)));
+            to = Blend(to, start, And(inBase, spawnRoll));
+            Store(&from[(size_t)i * lanes + l], s);
+            Store(&dest[(size_t)i * lanes + l], Blend(Set(-1), to, active));
+        }
+    }
+}
+
+void GameBatch::ApplyAvx2(const BatchMatchup& m) {
+    const __m256i zero = _mm256_setzero_si256(), ones = Set(-1);
+    for (int l = 0; l < lanes; l += BATCH_LANES) {
+        __m256i cur = Load(&current[l]), d = Load(&dice[l]);
+        __m256i np = Load(&nextPlace[l]), ply = Load(&plies[l]);
+        __m256i active = ActiveLanes(np, ply);
+        if (_mm256_testz_si256(active, active)) continue;
+        __m256i fp[NUM_PLAYERS], seat[NUM_PLAYERS];
+        for (int p = 0; p < NUM_PLAYERS; ++p) {
+            fp[p] = Load(&finishPlace[(size_t)p * lanes + l]);
+            seat[p] = Eq(cur, Set(p));
+        }
+
+        // Greedy pick: first piece with the highest score.
+        __m256i hero = Eq(cur, Load(&heroSeat[l]));
+        __m256i wSpawn = Blend(Set(m.field.spawn), Set(m.hero.spawn), hero);
+        __m256i wFinish = Blend(Set(m.field.finish), Set(m.hero.finish), hero);
+        __m256i wCapture = Blend(Set(m.field.capture), Set(m.hero.capture), hero);
+        __m256i best = Set(GREEDY_FLOOR), pick = ones, to = ones, firstPick = ones, firstTo = ones;
+        for (int i = 0; i < NUM_PIECES; ++i) {
+            __m256i s = Load(&from[(size_t)i * lanes + l]), t = Load(&dest[(size_t)i * lanes + l]);
+            __m256i legal = Gt(t, ones);
+            __m256i first = And(legal, Eq(firstPick, ones));
+            firstPick = Blend(firstPick, Set(i), first);
+            firstTo = Blend(firstTo, t, first);
+            __m256i capturesAt = AndNot(SafeLanes(t), And(legal, Gt(Set(LOOP_LEN), t)));
+            __m256i sOnLoop = And(Gt(s, ones), Gt(Set(LOOP_LEN), s));
+            __m256i score = Load(&jitter[(size_t)i * lanes + l]);
+            score = _mm256_add_epi32(score, And(Eq(s, Set(IN_BASE)), wSpawn));
+            score = _mm256_add_epi32(score, And(And(Gt(s, Set(LOOP_LEN - 1)), Eq(t, Set(HOME_STOP))), wFinish));
+            score = _mm256_add_epi32(score, And(And(sOnLoop, capturesAt), wCapture));
+            score = Blend(Set(NO_SCORE), score, legal);
+            __m256i better = Gt(score, best);
+            best = Blend(best, score, better);
+            pick = Blend(pick, Set(i), better);
+            to = Blend(to, t, better);
+        }
+        __m256i noPick = Eq(pick, ones);
+        pick = Blend(pick, firstPick, noPick);
+        to = Blend(to, firstTo, noPick);
+        __m256i mover = Gt(pick, ones);
+
+        // Move the piece, send captured opponents home, note whose pieces are all home.
+        __m256i captures = AndNot(SafeLanes(to), And(mover, Gt(Set(LOOP_LEN), to)));
+        __m256i moverAllHome = zero;
+        for (int p = 0; p < NUM_PLAYERS; ++p) {
+            __m256i moves = And(mover, seat[p]), hit = AndNot(seat[p], captures);
+            __m256i allHome = ones;
+            for (int i = 0; i < NUM_PIECES; ++i) {
+                int32_t* plane = &sq[(size_t)(p * NUM_PIECES + i) * lanes + l];
+                __m256i v = Load(plane);
+                v = Blend(v, to, And(moves, Eq(pick, Set(i))));
+                v = Blend(v, Set(IN_BASE), And(hit, Eq(v, to)));
+                Store(plane, v);
+                allHome = And(allHome, Eq(v, Set(HOME_STOP)));
+            }
+            moverAllHome = _mm256_or_si256(moverAllHome, And(seat[p], allHome));
+        }
+
+        // Finish places; with one seat left it takes the last place.
+        __m256i finished = And(And(mover, Eq(to, Set(HOME_STOP))), And(moverAllHome, Eq(BySeat(fp, cur), zero)));
+        for (int p = 0; p < NUM_PLAYERS; ++p) fp[p] = Blend(fp[p], np, And(finished, seat[p]));
+        np = _mm256_sub_epi32(np, finished);
+        __m256i last = And(finished, Eq(np, Set(NUM_PLAYERS)));
+        for (int p = 0; p < NUM_PLAYERS; ++p) fp[p] = Blend(fp[p], np, And(last, Eq(fp[p], zero)));
+        np = _mm256_sub_epi32(np, last);
+        for (int p = 0; p < NUM_PLAYERS; ++p) Store(&finishPlace[(size_t)p * lanes + l], fp[p]);
+        Store(&nextPlace[l], np);
+        Store(&plies[l], _mm256_sub_epi32(ply, active));
+
+        // Turn: a six rolls again unless that move finished the player;
+        // otherwise the next seat that is still playing.
+        __m256i over = Gt(np, Set(NUM_PLAYERS));
+        __m256i again = And(And(mover, Eq(d, Set(6))), Eq(BySeat(fp, cur), zero));
+        __m256i advance = AndNot(_mm256_or_si256(over, again), active);
+        __m256i nxt = And(_mm256_add_epi32(cur, Set(1)), Set(3));
+        for (int k = 0; k < NUM_PLAYERS - 1; ++k) {
+            __m256i done = AndNot(Eq(BySeat(fp, nxt), zero), ones);
+            nxt = Blend(nxt, And(_mm256_add_epi32(nxt, Set(1)), Set(3)), done);
+        }
+        Store(&current[l], Blend(cur, nxt, advance));
+    }
+}
+#endif
+
+// =================== DRIVER =====================
+void GameBatch::Play(const BatchMatchup& m, uint64_t seed, uint64_t first, uint64_t count,
+                     std::vector<BatchGameResult>& out) {
+    out.assign(count, BatchGameResult{});
+    uint64_t next = 0;
+    int live = 0;
+    auto park = [&](int l) { gameOf[l] = -1; nextPlace[l] = NUM_PLAYERS + 1; current[l] = 0; };
+    for (int l = 0; l < lanes; ++l) {
+        if (next < count) { StartGame(l, seed, first + next++); ++live; }
+        else park(l);
+    }
+    while (live > 0) {
+        RollDice();
+#if defined(__AVX2__)
+        if (useSimd) LegalAvx2(); else LegalScalar();
+#else
+        LegalScalar();
+#endif
+        DrawJitter(m);
+#if defined(__AVX2__)
+        if (useSimd) ApplyAvx2(m); else ApplyScalar(m);
+#else
+        ApplyScalar(m);
+#endif
+        for (int l = 0; l < lanes; ++l) {
+            if (gameOf[l] < 0 || LaneActive(nextPlace[l], plies[l])) continue;
+            BatchGameResult& r = out[(uint64_t)gameOf[l] - first];
+            for (int p = 0; p < NUM_PLAYERS; ++p) r.finishPlace[p] = (uint8_t)finishPlace[(size_t)p * lanes + l];
+            r.plies = (uint32_t)plies[l];
+            if (next < count) StartGame(l, seed, first + next++);
+            else { park(l); --live; }
+        }
+    }
+}
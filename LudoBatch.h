@@ -0,0 +1,64 @@
+#pragma once
+// Lockstep batch engine for self-play tuning.
+//
+// A GameBatch holds `lanes` classic games in structure-of-arrays form: one
+// int32 plane per (seat, piece) with that piece's square in every game,
+// plus per-game planes for the side to move, dice, finish places and ply
+// count. Each step rolls every game once and runs the rules and the greedy
+// policy over all of them: AVX2 kernels take 8 games per instruction when
+// the file is built with -mavx2, plain per-lane loops otherwise. A lane
+// whose game ends is refilled with the next game index, so the vectors
+// stay full until the batch runs out of games.
+//
+// Dice and jitter come from the same per-game CounterRng streams as
+// PlayGame(), so every game ends exactly as PlayGame() with greedy seats
+// would play it (ludo_tune --verify checks this).
+#include "LudoAi.h"
+#include <vector>
+
+static const int BATCH_LANES = 8;          // games per AVX2 vector; lane counts are rounded up to this
+
+// Game g seats the hero weights at seat g % NUM_PLAYERS and the field
+// weights everywhere else, so every seat is played equally often.
+struct BatchMatchup {
+    AiWeights hero;
+    AiWeights field;
+};
+
+struct BatchGameResult {
+    uint8_t  finishPlace[NUM_PLAYERS];
+    uint32_t plies;
+};
+
+class GameBatch {
+public:
+    explicit GameBatch(int lanes = 1024);
+
+    // Plays games [first, first + count) of `seed`; out[k] is game first + k.
+    void Play(const BatchMatchup& m, uint64_t seed, uint64_t first, uint64_t count,
+              std::vector<BatchGameResult>& out);
+
+    static bool SimdCompiled();             // built with AVX2 kernels
+    bool useSimd = SimdCompiled();          // false: scalar kernels (for comparison)
+    int  Lanes() const { return lanes; }
+
+private:
+    void StartGame(int lane, uint64_t seed, uint64_t game);
+    void RollDice();
+    void DrawJitter(const BatchMatchup& m);
+    void LegalScalar();
+    void ApplyScalar(const BatchMatchup& m);
+#if defined(__AVX2__)
+    void LegalAvx2();
+    void ApplyAvx2(const BatchMatchup& m);
+#endif
+
+    int lanes;
+    // Planes of `lanes` int32 each.
+    std::vector<int32_t> sq;                // [seat * NUM_PIECES + piece][lane]
+    std::vector<int32_t> finishPlace;       // [seat][lane]
+    std::vector<int32_t> current, nextPlace, dice, plies, heroSeat;
+    std::vector<int32_t> from, dest, jitter;   // per step: [piece][lane] for the side to move
+    std::vector<int64_t> gameOf;            // -1 = idle lane
+    std::vector<CounterRng> diceRng, aiRng;
+};
@@ -0,0 +1,383 @@
+// ludo_bench: micro- and macro-benchmarks with regression tracking.
+//
+//   ludo_bench [--filter SUBSTR] [--min-ms N] [--json FILE]
+//              [--compare BASELINE.json] [--threshold PCT]
+//
+// Every benchmark runs over a fixed corpus of positions taken from seeded
+// greedy games, so runs are comparable across builds. Each one is timed in
+// five batches of at least min-ms/5 and reports the median ns/op; with a
+// -DLUDO_COUNT_ALLOCS build it also reports heap allocations per op.
+// --compare reads an earlier --json file and exits 1 if any benchmark got
+// slower than the threshold (default 10%).
+#include "LudoAi.h"
+#include "AllocCounter.h"
+#include "LudoReplay.h"
+#include "LudoSnapshot.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static volatile uint64_t benchSink;             // keeps results observable
+
+struct Sample {
+    GameState s;
+    uint8_t dice;
+};
+
+struct Corpus {
+    std::vector<Sample> rolls;                  // every roll of the corpus games
+    std::vector<Sample> decisions;              // rolls with two or more legal moves
+    std::vector<std::pair<GameState, Move>> quiet, captures;
+    std::vector<uint8_t> replay;                // the corpus games as a replay file
+    std::vector<std::vector<Move>> games;       // every move of each corpus game, passes included
+};
+
+static Corpus corpus;
+
+static void BuildCorpus() {
+    Policy greedy;
+    CounterRng ai(42, 0, STREAM_AI);
+    ReplayEncoder enc;
+    WriteReplayFileHeader(enc.bytes);
+    for (uint64_t g = 0; g < 200; ++g) {
+        CounterRng dice(42, g, STREAM_DICE);
+        GameState s = NewGame();
+        enc.BeginGame(42, g);
+        corpus.games.emplace_back();
+        while (!IsGameOver(s)) {
+            int d = dice.RollDice();
+            corpus.rolls.push_back({ s, (uint8_t)d });
+            MoveList legal = LegalMoves(s, d);
+            if (legal.count > 1) corpus.decisions.push_back({ s, (uint8_t)d });
+            for (const Move& mv : legal) {
+                const StepEntry& st = StepFor(s.current, s.sq[s.current][mv.piece], d);
+                bool hits = false;
+                if (st.flags & STEP_CAPTURES)
+                    for (int op = 0; op < NUM_PLAYERS; ++op) hits |= op != s.current && Occupies(s, op, st.dest);
+                (hits ? corpus.captures : corpus.quiet).push_back({ s, mv });
+            }
+            Move mv = legal.empty() ? Move{ (int8_t)PASS, (uint8_t)d } : PickGreedyMove(s, legal, greedy.weights, ai);
+            int mover = s.current;
+            s = ApplyMove(s, mv);
+            enc.Record(mover, mv, s);
+            corpus.games.back().push_back(mv);
+        }
+        enc.EndGame();
+    }
+    corpus.replay = enc.bytes;
+}
+
+// =================== BENCHMARKS =================
+// Each runs `iters` passes' worth of work and returns the ops it did.
+static uint64_t BenchLegalMoves(uint64_t iters) {
+    uint64_t acc = 0, ops = 0;
+    for (uint64_t i = 0; i < iters; ++i)
+        for (const Sample& x : corpus.rolls) { acc += LegalMoves(x.s, x.dice).count; ++ops; }
+    benchSink = acc;
+    return ops;
+}
+
+static uint64_t BenchApply(const std::vector<std::pair<GameState, Move>>& set, uint64_t iters) {
+    uint64_t acc = 0, ops = 0;
+    for (uint64_t i = 0; i < iters; ++i)
+        for (const auto& x : set) { acc += ApplyMove(x.first, x.second).occ[0]; ++ops; }
+    benchSink = acc;
+    return ops;
+}
+static uint64_t BenchApplyQuiet(uint64_t iters) { return BenchApply(corpus.quiet, iters); }
+static uint64_t BenchApplyCapture(uint64_t iters) { return BenchApply(corpus.captures, iters); }
+
+// Plays each corpus game forward with MakeMove and unwinds it with
+// UnmakeMove; one op is one make/unmake pair.
+static uint64_t BenchMakeUnmake(uint64_t iters) {
+    static std::vector<UndoRecord> undo;
+    uint64_t acc = 0, ops = 0;
+    for (uint64_t i = 0; i < iters; ++i)
+        for (const std::vector<Move>& game : corpus.games) {
+            GameState s = NewGame();
+            EvalFeatures f = ComputeFeatures(s);
+            undo.resize(game.size());
+            for (size_t k = 0; k < game.size(); ++k) MakeMove(s, f, game[k], undo[k]);
+            acc += f.zobrist;
+            for (size_t k = game.size(); k-- > 0;) UnmakeMove(s, f, undo[k]);
+            acc += s.occ[0];
+            ops += game.size();
+        }
+    benchSink = acc;
+    return ops;
+}
+
+static uint64_t BenchZobrist(uint64_t iters) {
+    uint64_t acc = 0, ops = 0;
+    for (uint64_t i = 0; i < iters; ++i)
+        for (const Sample& x : corpus.rolls) { acc ^= ZobristHash(x.s); ++ops; }
+    benchSink = acc;
+    return ops;
+}
+
+static uint64_t BenchPick(const Policy& policy, size_t limit, uint64_t iters) {
+    CounterRng rng(7, 0, STREAM_AI);
+    uint64_t acc = 0, ops = 0;
+    size_t n = std::min(limit, corpus.decisions.size());
+    for (uint64_t i = 0; i < iters; ++i)
+        for (size_t k = 0; k < n; ++k) {
+            const Sample& x = corpus.decisions[k];
+            acc += PickPolicyMove(policy, x.s, LegalMoves(x.s, x.dice), rng).piece;
+            ++ops;
+        }
+    benchSink = acc;
+    return ops;
+}
+static uint64_t BenchPickGreedy(uint64_t iters) { return BenchPick(Policy(), SIZE_MAX, iters); }
+static uint64_t BenchPickSearch2(uint64_t iters) {
+    Policy p;
+    p.kind = POLICY_SEARCH;
+    p.search = { 2, 0 };
+    return BenchPick(p, 256, iters);
+}
+
+// Game lengths vary a lot, so every batch starts over at game 0 and cycles
+// through the same BENCH_GAMES games. The game rows time multiples of
+// BENCH_GAMES iterations (Benchmark::iterStep), so each batch plays every
+// game equally often and every build times the same work.
+static const uint64_t BENCH_GAMES = 64;
+
+template <class V = ClassicBoard>
+static uint64_t BenchGame(PolicyKind kind, uint64_t iters) {
+    Policy seats[V::PLAYERS];
+    for (Policy& p : seats) p.kind = kind;
+    uint64_t acc = 0;
+    for (uint64_t i = 0; i < iters; ++i) acc += PlayGame<V>(seats, 1, i % BENCH_GAMES).plies;
+    benchSink = acc;
+    return iters;
+}
+static uint64_t BenchGameGreedy(uint64_t iters) { return BenchGame(POLICY_GREEDY, iters); }
+static uint64_t BenchGameRandom(uint64_t iters) { return BenchGame(POLICY_RANDOM, iters); }
+static uint64_t BenchGameGreedy2p(uint64_t iters) { return BenchGame<DuelBoard>(POLICY_GREEDY, iters); }
+static uint64_t BenchGameGreedy6p(uint64_t iters) { return BenchGame<SixBoard>(POLICY_GREEDY, iters); }
+
+// The engine side of one GUI frame without raylib: place all sixteen
+// pieces on board cells, count stacks per cell and work out which pieces
+// are clickable for the current roll (Ludo.cpp PieceCell / draw loop).
+static uint64_t BenchFrameLogic(uint64_t iters) {
+    uint64_t acc = 0, ops = 0;
+    for (uint64_t i = 0; i < iters; ++i)
+        for (const Sample& x : corpus.rolls) {
+            const GameState& s = x.s;
+            uint8_t cellCount[15][15] = {};
+            MoveList legal = LegalMoves(s, x.dice);
+            for (int p = 0; p < NUM_PLAYERS; ++p)
+                for (int k = 0; k < NUM_PIECES; ++k) {
+                    int sq = s.sq[p][k];
+                    BoardCell c = (sq == IN_BASE) ? BoardCell{ (int8_t)(p <= 1 ? k / 2 : 12 + k / 2), (int8_t)((p == 0 || p == 2) ? k % 2 : 12 + k % 2) }
+                                : IsInFinal(sq) ? BOARD.finalPath[p][sq - LOOP_LEN] : BOARD.loop[sq];
+                    acc += ++cellCount[c.r][c.c];
+                    acc += (p == s.current && legal.Contains(k));
+                }
+            ++ops;
+        }
+    benchSink = acc;
+    return ops;
+}
+
+static uint64_t BenchReplaySeek(uint64_t iters) {
+    int interval;
+    CheckReplayFileHeader(corpus.replay.data(), corpus.replay.size(), interval);
+    uint64_t acc = 0, ops = 0;
+    for (uint64_t i = 0; i < iters; ++i) {
+        size_t at = sizeof(ReplayFileHeader), next;
+        ReplayGameView g;
+        while ((next = NextReplayGame(corpus.replay.data(), corpus.replay.size(), at, interval, g)) != 0) {
+            GameState s;
+            SeekReplay(g, g.turns * 2 / 3, s);
+            acc += s.current;
+            ++ops;
+            at = next;
+        }
+    }
+    benchSink = acc;
+    return ops;
+}
+
+// Every corpus position is snapshotted into an undo ring and the one
+// before it restored; one op is take + push + undo + restore.
+static uint64_t BenchSnapshotUndo(uint64_t iters) {
+    static HistoryRing<Snapshot, 256> history;
+    const CounterRng dice(1, 0, STREAM_DICE), ai(1, 0, STREAM_AI);
+    uint64_t acc = 0, ops = 0;
+    for (uint64_t i = 0; i < iters; ++i)
+        for (const Sample& x : corpus.rolls) {
+            Snapshot s{ x.s, dice, ai, (uint32_t)ops, x.dice, 1, {} };
+            history.Push(std::move(s));
+            if (const Snapshot* u = history.Undo()) {
+                Snapshot back = *u;
+                acc += back.turns + back.game.current;
+            }
+            ++ops;
+        }
+    benchSink = acc;
+    return ops;
+}
+
+struct Benchmark {
+    const char* name;
+    const char* unit;                           // what one op is
+    uint64_t (*run)(uint64_t iters);
+    uint64_t iterStep = 1;                      // timed iteration counts are multiples of this
+};
+
+static const Benchmark BENCHMARKS[] = {
+    { "legal_moves",      "roll",     BenchLegalMoves },
+    { "apply_quiet",      "move",     BenchApplyQuiet },
+    { "apply_capture",    "move",     BenchApplyCapture },
+    { "make_unmake",      "move",     BenchMakeUnmake },
+    { "zobrist_hash",     "state",    BenchZobrist },
+    { "pick_greedy",      "decision", BenchPickGreedy },
+    { "pick_search_d2",   "decision", BenchPickSearch2 },
+    { "frame_logic",      "frame",    BenchFrameLogic },
+    { "replay_seek",      "seek",     BenchReplaySeek },
+    { "snapshot_undo",    "turn",     BenchSnapshotUndo },
+    { "game_greedy",      "game",     BenchGameGreedy,   BENCH_GAMES },
+    { "game_random",      "game",     BenchGameRandom,   BENCH_GAMES },
+    { "game_greedy_2p",   "game",     BenchGameGreedy2p, BENCH_GAMES },
+    { "game_greedy_6p",   "game",     BenchGameGreedy6p, BENCH_GAMES },
+};
+
+struct BenchResult {
+    std::string name, unit;
+    double nsPerOp = 0, allocsPerOp = -1;       // -1: not counted in this build
+};
+
+static BenchResult Measure(const Benchmark& b, double minMs) {
+    b.run(1);                                   // warm-up: first-touch tables, search TT
+    uint64_t iters = b.iterStep;                // doubling keeps it a multiple
+    for (;;) {
+        auto t0 = Clock::now();
+        b.run(iters);
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        if (ms >= minMs / 5 || iters >= (1ull << 30)) break;
+        iters *= 2;
+    }
+    std::vector<double> ns;
+    uint64_t allocs = 0, ops = 0;
+    for (int rep = 0; rep < 5; ++rep) {
+        AllocScope scope;
+        auto t0 = Clock::now();
+        uint64_t n = b.run(iters);
+        double el = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+        allocs += scope.Count();
+        ops += n;
+        ns.push_back(el / (double)n);
+    }
+    std::sort(ns.begin(), ns.end());
+    BenchResult r;
+    r.name = b.name; r.unit = b.unit;
+    r.nsPerOp = ns[ns.size() / 2];
+    if (AllocCountingEnabled()) r.allocsPerOp = (double)allocs / (double)ops;
+    return r;
+}
+
+// =================== REPORTING ==================
+static bool WriteJson(const char* path, const std::vector<BenchResult>& results) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "{\n  \"version\": 1,\n  \"results\": [");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        fprintf(f, "%s\n    { \"name\": \"%s\", \"unit\": \"%s\", \"ns_per_op\": %.3f, \"ops_per_sec\": %.1f, \"allocs_per_op\": ",
+            i ? "," : "", r.name.c_str(), r.unit.c_str(), r.nsPerOp, 1e9 / r.nsPerOp);
+        if (r.allocsPerOp < 0) fprintf(f, "null }");
+        else fprintf(f, "%.4f }", r.allocsPerOp);
+    }
+    fprintf(f, "\n  ]\n}\n");
+    fclose(f);
+    return true;
+}
+
+// Reads back what WriteJson wrote: name -> ns_per_op.
+static bool ReadBaseline(const char* path, std::vector<std::pair<std::string, double>>& out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    std::string text;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) text.append(buf, n);
+    fclose(f);
+    size_t at = 0;
+    while ((at = text.find("\"name\": \"", at)) != std::string::npos) {
+        at += 9;
+        size_t end = text.find('"', at);
+        size_t ns = text.find("\"ns_per_op\": ", end);
+        if (end == std::string::npos || ns == std::string::npos) break;
+        out.push_back({ text.substr(at, end - at), atof(text.c_str() + ns + 13) });
+        at = ns;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* filter = nullptr;
+    const char* jsonPath = nullptr;
+    const char* baselinePath = nullptr;
+    double minMs = 300.0, threshold = 10.0;
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!strcmp(a, "--filter") && v) { filter = v; ++i; }
+        else if (!strcmp(a, "--min-ms") && v) { minMs = atof(v); ++i; }
+        else if (!strcmp(a, "--json") && v) { jsonPath = v; ++i; }
+        else if (!strcmp(a, "--compare") && v) { baselinePath = v; ++i; }
+        else if (!strcmp(a, "--threshold") && v) { threshold = atof(v); ++i; }
+        else if (!strcmp(a, "--list")) {
+            for (const Benchmark& b : BENCHMARKS) printf("%s\n", b.name);
+            return 0;
+        }
+        else {
+            fprintf(stderr, "usage: %s [--filter SUBSTR] [--min-ms N] [--json FILE] [--compare BASELINE.json] [--threshold PCT] [--list]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<std::pair<std::string, double>> baseline;
+    if (baselinePath && !ReadBaseline(baselinePath, baseline)) {
+        fprintf(stderr, "cannot read baseline %s\n", baselinePath);
+        return 2;
+    }
+
+    BuildCorpus();
+    printf("corpus: %zu rolls, %zu decisions, %zu quiet moves, %zu captures\n\n", corpus.rolls.size(),
+        corpus.decisions.size(), corpus.quiet.size(), corpus.captures.size());
+    printf("%-16s %14s %10s %14s %s\n", "benchmark", "ns/op", "allocs/op", "ops/s", baseline.empty() ? "" : "  vs baseline");
+
+    std::vector<BenchResult> results;
+    int regressions = 0;
+    for (const Benchmark& b : BENCHMARKS) {
+        if (filter && !strstr(b.name, filter)) continue;
+        BenchResult r = Measure(b, minMs);
+        results.push_back(r);
+        char allocs[32];
+        if (r.allocsPerOp < 0) snprintf(allocs, sizeof(allocs), "-");
+        else snprintf(allocs, sizeof(allocs), "%.3f", r.allocsPerOp);
+        printf("%-16s %14.2f %10s %14.0f", r.name.c_str(), r.nsPerOp, allocs, 1e9 / r.nsPerOp);
+        for (const auto& base : baseline) {
+            if (base.first != r.name || base.second <= 0) continue;
+            double change = 100.0 * (r.nsPerOp - base.second) / base.second;
+            bool slower = change > threshold;
+            regressions += slower;
+            printf("  %+7.1f%%%s", change, slower ? "  REGRESSION" : "");
+        }
+        printf("  (per %s)\n", r.unit.c_str());
+        fflush(stdout);
+    }
+
+    if (jsonPath && !WriteJson(jsonPath, results)) { fprintf(stderr, "cannot write %s\n", jsonPath); return 2; }
+    if (!baseline.empty())
+        printf("\n%d regression(s) beyond %.1f%% against %s\n", regressions, threshold, baselinePath);
+    return regressions ? 1 : 0;
+}
@@ -0,0 +1,210 @@
+#pragma once
+// Board variants, their geometry and move tables, all built at compile time.
+//
+// A variant is a plain traits type (seat count, path lengths, start
+// squares, extra safe squares). Everything derived from it - the step
+// tables below, GameState's layout, the Zobrist keys - is a template over
+// that type, so each variant gets its own fixed-size tables and loops with
+// constant trip counts instead of one runtime-configurable engine.
+// MakeStepTables() precomputes every (player, square, dice) move so the
+// engine never looks at path lengths at run time.
+#include <cstdint>
+
+// =================== RULES CONFIG ===============
+static const int NUM_PIECES = 4;
+static const int IN_BASE = -1;
+static const int MAX_SEATS = 6;                // largest variant below
+
+// Square numbering is the same in every variant: IN_BASE, then the shared
+// loop 0..LOOP_LEN-1, then each player's own strip up to HOME_STOP. The
+// loop does not wrap: every player walks from its start index to the end
+// of the loop and then turns into its own home strip.
+template <int Players, int LoopLen, int FinalLen, int FirstPlayer>
+struct BoardShape {
+    static constexpr int PLAYERS = Players;
+    static constexpr int LOOP_LEN = LoopLen;
+    static constexpr int FINAL_LEN = FinalLen;
+    static constexpr int HOME_STOP = LoopLen + FinalLen - 1;
+    static constexpr int NUM_SQUARES = HOME_STOP + 2;   // IN_BASE plus 0..HOME_STOP, indexed sq + 1
+    static constexpr int FIRST_PLAYER = FirstPlayer;    // seat that opens the game
+    static constexpr uint64_t LOOP_MASK = (1ull << LoopLen) - 1;
+    static_assert(Players >= 2 && Players <= MAX_SEATS, "2..MAX_SEATS seats");
+    static_assert(HOME_STOP < 64, "occupancy masks are 64-bit");
+};
+
+// The original game: 15x15 cross, 43-cell loop, four seats.
+// 0=YELLOW, 1=BLUE, 2=GREEN, 3=RED; RED (you) opens.
+struct ClassicBoard : BoardShape<4, 43, 6, 3> {
+    static constexpr int START[PLAYERS] = { 0, 11, 23, 35 };
+    static constexpr int CROSS_ARM[PLAYERS] = { 0, 1, 2, 3 };   // arm of the cross each seat owns
+    static constexpr uint64_t EXTRA_SAFE = (1ull << 18) | (1ull << 38);   // both visits to (6,6)
+};
+
+// Two-player house rules on the same cross: YELLOW against RED, the other
+// two arms stay empty and their start squares are ordinary cells.
+struct DuelBoard : BoardShape<2, 43, 6, 1> {
+    static constexpr int START[PLAYERS] = { 0, 35 };
+    static constexpr int CROSS_ARM[PLAYERS] = { 0, 3 };
+    static constexpr uint64_t EXTRA_SAFE = (1ull << 18) | (1ull << 38);
+};
+
+// Six-player house rules: a longer 56-cell loop with six evenly spread
+// starts and shorter 5-cell strips. Headless only (no cross layout).
+struct SixBoard : BoardShape<6, 56, 5, 0> {
+    static constexpr int START[PLAYERS] = { 0, 9, 19, 28, 37, 47 };
+    static constexpr uint64_t EXTRA_SAFE = 0;
+};
+
+// The classic board's numbers under their old names; code that only ever
+// plays the four-seat game (replays, server, tablebase) uses these.
+static const int NUM_PLAYERS = ClassicBoard::PLAYERS;
+static const int LOOP_LEN = ClassicBoard::LOOP_LEN;       // cells in outerPath
+static const int FINAL_LEN = ClassicBoard::FINAL_LEN;     // cells in each finalPaths[p]
+static const int HOME_STOP = ClassicBoard::HOME_STOP;
+static const int NUM_SQUARES = ClassicBoard::NUM_SQUARES;
+static constexpr const int (&START_INDEX)[NUM_PLAYERS] = ClassicBoard::START;
+
+// Bit i = loop square i is safe: every start plus the variant's extras.
+template <class V>
+constexpr uint64_t MakeSafeMask() {
+    uint64_t m = V::EXTRA_SAFE;
+    for (int p = 0; p < V::PLAYERS; ++p) m |= 1ull << V::START[p];
+    return m;
+}
+
+template <class V>
+inline constexpr uint64_t SAFE_MASK = MakeSafeMask<V>();
+static constexpr uint64_t SAFE_LOOP_MASK = SAFE_MASK<ClassicBoard>;
+
+// =================== GEOMETRY ===================
+// Screen cells of the 15x15 cross, for the variants that have CROSS_ARM.
+struct BoardCell { int8_t r, c; };
+
+static const int CROSS_N = 15;
+static const int CROSS_ARMS = 4;
+
+template <class V>
+struct BoardGeometry {
+    BoardCell loop[V::LOOP_LEN];
+    BoardCell finalPath[V::PLAYERS][V::FINAL_LEN];
+    BoardCell base[V::PLAYERS];                 // top-left of the 2x2 base block
+};
+
+template <class V>
+constexpr BoardGeometry<V> MakeBoardGeometry() {
+    static_assert(V::LOOP_LEN == 43 && V::FINAL_LEN == 6, "the cross has a 43-cell loop and 6-cell strips");
+    BoardGeometry<V> g{};
+    int n = 0;
+    auto push = [&](int r, int c) { g.loop[n].r = (int8_t)r; g.loop[n].c = (int8_t)c; ++n; };
+    // The loop runs around the central cross (43 cells).
+    for (int c = 3; c <= 11; c++) push(1, c);     // across top
+    for (int r = 2; r <= 6; r++) push(r, 11);     // down right
+    for (int c = 10; c >= 6; c--) push(6, c);     // left mid
+    for (int r = 7; r <= 11; r++) push(r, 6);     // down center
+    for (int c = 5; c >= 1; c--) push(11, c);     // left bottom
+    for (int r = 10; r >= 6; r--) push(r, 1);     // up left
+    for (int c = 2; c <= 6; c++) push(6, c);      // right mid
+    for (int r = 5; r >= 2; r--) push(r, 6);      // up center
+
+    // Final home paths (6 cells; index 5 is the "home stop") and base corners
+    for (int p = 0; p < V::PLAYERS; ++p) {
+        int arm = V::CROSS_ARM[p];
+        for (int k = 0; k < V::FINAL_LEN; ++k) {
+            BoardCell& f = g.finalPath[p][k];
+            if (arm == 0) f = { (int8_t)(5 - k), 6 };   // Yellow up
+            if (arm == 1) f = { 6, (int8_t)(5 - k) };   // Blue left
+            if (arm == 2) f = { (int8_t)(7 + k), 6 };   // Green down
+            if (arm == 3) f = { 6, (int8_t)(7 + k) };   // Red right
+        }
+        g.base[p] = { (int8_t)(arm <= 1 ? 0 : CROSS_N - 3), (int8_t)(arm == 0 || arm == 2 ? 0 : CROSS_N - 3) };
+    }
+    return g;
+}
+
+template <class V>
+inline constexpr BoardGeometry<V> GEOMETRY = MakeBoardGeometry<V>();
+static constexpr const BoardGeometry<ClassicBoard>& BOARD = GEOMETRY<ClassicBoard>;
+
+// The extra safe squares are the loop's only self-crossing.
+template <class V>
+constexpr bool CrossingIsExtraSafe() {
+    const BoardGeometry<V> g = MakeBoardGeometry<V>();
+    uint64_t crossing = 0;
+    for (int i = 0; i < V::LOOP_LEN; ++i)
+        for (int j = 0; j < V::LOOP_LEN; ++j)
+            if (i != j && g.loop[i].r == g.loop[j].r && g.loop[i].c == g.loop[j].c) crossing |= 1ull << i;
+    return crossing == V::EXTRA_SAFE;
+}
+
+// =================== STEP TABLES ================
+enum StepFlags : uint8_t {
+    STEP_SPAWN      = 1 << 0,   // leaves base onto the start square
+    STEP_SAFE       = 1 << 1,   // lands on a safe loop square
+    STEP_CAPTURES   = 1 << 2,   // lands on a non-safe loop square: opponents there go home
+    STEP_ENTERS_HOME = 1 << 3,  // crosses from the loop into the home strip
+    STEP_COMPLETES  = 1 << 4,   // lands on the home stop
+};
+
+struct StepEntry {
+    int8_t  dest;               // destination square, -1 = illegal
+    uint8_t flags;
+};
+
+template <class V>
+struct StepTables {
+    StepEntry e[V::PLAYERS][V::NUM_SQUARES][7];   // [player][sq + 1][dice], dice 1..6
+};
+
+template <class V>
+constexpr StepTables<V> MakeStepTables() {
+    StepTables<V> t{};
+    for (int p = 0; p < V::PLAYERS; ++p)
+        for (int s = 0; s < V::NUM_SQUARES; ++s)
+            for (int d = 0; d <= 6; ++d) {
+                int sq = s - 1;
+                StepEntry& e = t.e[p][s][d];
+                e.dest = -1; e.flags = 0;
+                if (d == 0) continue;
+                int dst = -1;
+                if (sq == IN_BASE) {
+                    if (d != 6) continue;
+                    dst = V::START[p];
+                    e.flags |= STEP_SPAWN;
+                }
+                else {
+                    if (sq + d > V::HOME_STOP) continue;
+                    dst = sq + d;
+                    if (sq < V::LOOP_LEN && dst >= V::LOOP_LEN) e.flags |= STEP_ENTERS_HOME;
+                }
+                e.dest = (int8_t)dst;
+                if (dst < V::LOOP_LEN) e.flags |= ((SAFE_MASK<V> >> dst) & 1ull) ? STEP_SAFE : STEP_CAPTURES;
+                if (dst == V::HOME_STOP) e.flags |= STEP_COMPLETES;
+            }
+    return t;
+}
+
+template <class V>
+inline constexpr StepTables<V> STEP_TABLES = MakeStepTables<V>();
+static constexpr const StepTables<ClassicBoard>& STEPS = STEP_TABLES<ClassicBoard>;
+
+template <class V = ClassicBoard>
+inline const StepEntry& StepFor(int player, int sq, int dice) { return STEP_TABLES<V>.e[player][sq + 1][dice]; }
+
+// Spot checks that the tables agree with the old path-walking rules.
+static_assert(CrossingIsExtraSafe<ClassicBoard>() && CrossingIsExtraSafe<DuelBoard>(), "(6,6) is the only crossing");
+static_assert(SAFE_LOOP_MASK == ((1ull << 0) | (1ull << 11) | (1ull << 18) | (1ull << 23) | (1ull << 35) | (1ull << 38)),
+              "safe squares: four starts + both visits to (6,6)");
+static_assert(STEPS.e[3][1 + IN_BASE][6].dest == 35 && (STEPS.e[3][1 + IN_BASE][6].flags & STEP_SAFE), "red spawns on 35");
+static_assert(STEPS.e[3][1 + 42][1].dest == LOOP_LEN && (STEPS.e[3][1 + 42][1].flags & STEP_ENTERS_HOME), "last loop cell -> finalIdx 0");
+static_assert(STEPS.e[0][1 + 42][6].dest == HOME_STOP && (STEPS.e[0][1 + 42][6].flags & STEP_COMPLETES), "excess 6 -> home stop");
+static_assert(STEPS.e[1][1 + 45][4].dest == -1, "no overshooting the home stop");
+static_assert(STEPS.e[2][1 + 40][1].flags & STEP_CAPTURES, "plain loop cell captures");
+static_assert(STEP_TABLES<DuelBoard>.e[1][1 + IN_BASE][6].dest == 35, "duel red spawns where classic red does");
+static_assert(STEP_TABLES<DuelBoard>.e[0][1 + 10][1].flags & STEP_CAPTURES, "no duel seat starts on 11");
+static_assert(STEP_TABLES<SixBoard>.e[5][1 + 55][5].dest == SixBoard::HOME_STOP, "six seats: 5-cell strips");
+
+// Walks every table entry of variant V against a step-by-step
+// reimplementation of the original outerIdx/finalIdx rules. Returns the
+// number of mismatches.
+template <class V = ClassicBoard>
+int VerifyStepTables();
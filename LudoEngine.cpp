@@ -0,0 +1,420 @@
+#include "LudoEngine.h"
+#include "LudoRandom.h"
+#include <cstring>
+#include <vector>
+
+// =================== SETUP ======================
+template <class V>
+BasicGameState<V> NewGame() {
+    BasicGameState<V> s;
+    std::memset(&s, 0, sizeof(s));
+    for (int p = 0; p < V::PLAYERS; ++p)
+        for (int i = 0; i < NUM_PIECES; ++i) s.sq[p][i] = IN_BASE;
+    s.current = V::FIRST_PLAYER;
+    s.nextPlace = 1;
+    RebuildOccupancy(s);
+    return s;
+}
+
+template <class V>
+void RebuildOccupancy(BasicGameState<V>& s) {
+    for (int p = 0; p < V::PLAYERS; ++p) {
+        s.occ[p] = 0; s.baseCount[p] = 0; s.doneCount[p] = 0;
+        for (int i = 0; i < NUM_PIECES; ++i) {
+            int sq = s.sq[p][i];
+            if (sq == IN_BASE) { s.baseCount[p]++; continue; }
+            s.occ[p] |= SquareBit(sq);
+            if (sq == V::HOME_STOP) s.doneCount[p]++;
+        }
+    }
+}
+
+// =================== RULES ======================
+template <class V>
+MoveList LegalMoves(const BasicGameState<V>& s, int dice) {
+    MoveList r;
+    if (IsGameOver(s)) return r;
+    int p = s.current;
+    if (!HasLegalMove(s, dice)) return r;
+    for (int i = 0; i < NUM_PIECES; ++i)
+        if (StepFor<V>(p, s.sq[p][i], dice).dest >= 0) r.m[r.count++] = { (int8_t)i, (uint8_t)dice };
+    return r;
+}
+
+template <class V>
+static void AdvanceTurn(BasicGameState<V>& s) {
+    if (IsGameOver(s)) return;
+    int nxt = (s.current + 1) % V::PLAYERS;
+    while (IsFinished(s, nxt)) nxt = (nxt + 1) % V::PLAYERS;
+    s.current = (uint8_t)nxt;
+}
+
+template <class V>
+BasicGameState<V> ApplyMove(const BasicGameState<V>& in, Move mv) {
+    BasicGameState<V> s = in;
+    int p = s.current;
+    if (mv.piece == PASS) { AdvanceTurn(s); return s; }
+
+    int from = s.sq[p][mv.piece];
+    const StepEntry& step = StepFor<V>(p, from, mv.dice);
+    int dst = step.dest;
+    if (dst < 0) return s;                      // illegal: leave the state untouched
+    s.sq[p][mv.piece] = (int8_t)dst;
+
+    // Lift the piece: the square stays marked if another own piece shares it.
+    if (from == IN_BASE) s.baseCount[p]--;
+    else {
+        bool stacked = false;
+        for (int i = 0; i < NUM_PIECES; ++i) stacked |= (i != mv.piece && s.sq[p][i] == from);
+        if (!stacked) s.occ[p] &= ~SquareBit(from);
+    }
+    s.occ[p] |= SquareBit(dst);
+
+    // Capture: every opponent on the same loop square goes back to base.
+    if (step.flags & STEP_CAPTURES) {
+        uint64_t bit = SquareBit(dst);
+        for (int op = 0; op < V::PLAYERS; ++op) {
+            if (op == p || !(s.occ[op] & bit)) continue;
+            s.occ[op] &= ~bit;
+            for (int i = 0; i < NUM_PIECES; ++i)
+                if (s.sq[op][i] == dst) { s.sq[op][i] = IN_BASE; s.baseCount[op]++; }
+        }
+    }
+
+    // Finish check, and with one seat left it takes the last place.
+    if ((step.flags & STEP_COMPLETES) && ++s.doneCount[p] == NUM_PIECES && !IsFinished(s, p)) {
+        s.finishPlace[p] = s.nextPlace++;
+        if (s.nextPlace == V::PLAYERS)
+            for (int op = 0; op < V::PLAYERS; ++op)
+                if (!IsFinished(s, op)) s.finishPlace[op] = s.nextPlace++;
+    }
+
+    // A six earns another roll, unless that move just finished the player.
+    if (mv.dice != 6 || IsFinished(s, p)) AdvanceTurn(s);
+    return s;
+}
+
+template <class V>
+uint64_t HashState(const BasicGameState<V>& s) {
+    // FNV-1a over the raw bytes; GameState has no padding to worry about.
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(&s);
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < sizeof(s); ++i) { h ^= b[i]; h *= 1099511628211ull; }
+    return h;
+}
+
+// =================== ZOBRIST ====================
+template <class V>
+struct ZobristKeys {
+    uint64_t sq[V::PLAYERS][NUM_PIECES][V::NUM_SQUARES];   // [.][.][sq + 1], IN_BASE at 0
+    uint64_t turn[V::PLAYERS];
+    uint64_t place[V::PLAYERS][V::PLAYERS + 1];
+};
+
+template <class V>
+static constexpr ZobristKeys<V> MakeZobristKeys() {
+    ZobristKeys<V> k{};
+    uint64_t n = 0x5A0B1257ull;
+    for (int p = 0; p < V::PLAYERS; ++p)
+        for (int i = 0; i < NUM_PIECES; ++i)
+            for (int s = 0; s < V::NUM_SQUARES; ++s) k.sq[p][i][s] = Mix64(n++);
+    for (int p = 0; p < V::PLAYERS; ++p) k.turn[p] = Mix64(n++);
+    for (int p = 0; p < V::PLAYERS; ++p)
+        for (int f = 0; f <= V::PLAYERS; ++f) k.place[p][f] = f ? Mix64(n++) : 0;
+    return k;
+}
+
+template <class V>
+static constexpr ZobristKeys<V> ZOBRIST = MakeZobristKeys<V>();
+
+template <class V>
+uint64_t ZobristHash(const BasicGameState<V>& s) {
+    const ZobristKeys<V>& z = ZOBRIST<V>;
+    uint64_t h = z.turn[s.current];
+    for (int p = 0; p < V::PLAYERS; ++p) {
+        for (int i = 0; i < NUM_PIECES; ++i) h ^= z.sq[p][i][s.sq[p][i] + 1];
+        h ^= z.place[p][s.finishPlace[p]];
+    }
+    return h;
+}
+
+// =================== MAKE / UNMAKE ==============
+template <class V>
+static int PathLength(int player) { return V::HOME_STOP - V::START[player] + 1; }
+
+template <class V>
+static int Remaining(int player, int sq) { return sq == IN_BASE ? PathLength<V>(player) : V::HOME_STOP - sq; }
+
+// Loop squares a piece on `sq` could hit with one roll.
+template <class V>
+static uint64_t Reach(int sq) { return IsOnLoop<V>(sq) ? (0x7Eull << sq) & V::LOOP_MASK : 0; }
+
+// Non-safe loop squares 1..6 ahead of an `enemy` piece.
+template <class V>
+static uint64_t Threatened(uint64_t enemy) {
+    uint64_t t = enemy << 1;                    // 1
+    t |= t << 1;                                // 1..2
+    t |= t << 2;                                // 1..4
+    t |= (enemy << 5) | (enemy << 6);           // 1..6
+    return t & V::LOOP_MASK & ~SAFE_MASK<V>;
+}
+
+template <class V>
+static void CountExposed(const BasicGameState<V>& s, BasicEvalFeatures<V>& f, int p, uint64_t threatened) {
+    int n = 0, progress = 0;
+    for (int i = 0; i < NUM_PIECES; ++i) {
+        int sq = s.sq[p][i];
+        int hit = (int)((threatened >> (sq & 63)) & 1);   // IN_BASE reads bit 63, never set
+        n += hit;
+        progress += hit * (sq - V::START[p] + 1);
+    }
+    f.exposed[p] = (uint8_t)n;
+    f.exposedProgress[p] = (int16_t)progress;
+}
+
+// Recounts the seats in `seats`, building each seat's enemy mask once.
+template <class V>
+static void CountExposed(const BasicGameState<V>& s, BasicEvalFeatures<V>& f, unsigned seats) {
+    uint64_t loop[V::PLAYERS];
+    for (int op = 0; op < V::PLAYERS; ++op) loop[op] = s.occ[op] & V::LOOP_MASK;
+    for (int p = 0; seats; ++p, seats >>= 1) {
+        if (!(seats & 1)) continue;
+        uint64_t enemy = 0;
+        for (int op = 0; op < V::PLAYERS; ++op) if (op != p) enemy |= loop[op];
+        CountExposed(s, f, p, Threatened<V>(enemy));
+    }
+}
+
+template <class V>
+BasicEvalFeatures<V> ComputeFeatures(const BasicGameState<V>& s) {
+    BasicEvalFeatures<V> f;
+    std::memset(&f, 0, sizeof(f));
+    f.zobrist = ZobristHash(s);
+    for (int p = 0; p < V::PLAYERS; ++p) {
+        int distance = 0, safe = 0;
+        for (int i = 0; i < NUM_PIECES; ++i) {
+            distance += Remaining<V>(p, s.sq[p][i]);
+            safe += IsSafeSquare<V>(s.sq[p][i]);
+        }
+        f.distance[p] = (int16_t)distance;
+        f.safe[p] = (uint8_t)safe;
+    }
+    CountExposed(s, f, (1u << V::PLAYERS) - 1);
+    return f;
+}
+
+template <class V>
+void MakeMove(BasicGameState<V>& s, BasicEvalFeatures<V>& f, Move mv, BasicUndoRecord<V>& u) {
+    const ZobristKeys<V>& z = ZOBRIST<V>;
+    int p = s.current;
+    u.features = f;
+    u.move = mv;
+    u.from = IN_BASE;
+    u.current = s.current;
+    u.nextPlace = s.nextPlace;
+    u.hit = 0;
+    u.placed = 0;
+
+    if (mv.piece != PASS) {
+        int from = s.sq[p][mv.piece];
+        const StepEntry& step = StepFor<V>(p, from, mv.dice);
+        int dst = step.dest;
+        u.from = (int8_t)from;
+        s.sq[p][mv.piece] = (int8_t)dst;
+        if (from == IN_BASE) s.baseCount[p]--;
+        else {
+            bool stacked = false;
+            for (int i = 0; i < NUM_PIECES; ++i) stacked |= (i != mv.piece && s.sq[p][i] == from);
+            if (!stacked) s.occ[p] &= ~SquareBit(from);
+        }
+        s.occ[p] |= SquareBit(dst);
+        f.zobrist ^= z.sq[p][mv.piece][from + 1] ^ z.sq[p][mv.piece][dst + 1];
+        f.distance[p] = (int16_t)(f.distance[p] - Remaining<V>(p, from) + Remaining<V>(p, dst));
+        f.safe[p] = (uint8_t)(f.safe[p] - IsSafeSquare<V>(from) + IsSafeSquare<V>(dst));
+
+        // Captured pieces land on an unsafe square, so only their distance changes.
+        if (step.flags & STEP_CAPTURES) {
+            uint64_t bit = SquareBit(dst);
+            for (int op = 0; op < V::PLAYERS; ++op) {
+                if (op == p || !(s.occ[op] & bit)) continue;
+                s.occ[op] &= ~bit;
+                u.hit |= (uint8_t)(1u << op);
+                u.captured[op] = 0;
+                for (int i = 0; i < NUM_PIECES; ++i) {
+                    if (s.sq[op][i] != dst) continue;
+                    s.sq[op][i] = IN_BASE;
+                    s.baseCount[op]++;
+                    u.captured[op] |= (uint8_t)(1u << i);
+                    f.zobrist ^= z.sq[op][i][dst + 1] ^ z.sq[op][i][0];
+                    f.distance[op] = (int16_t)(f.distance[op] + PathLength<V>(op) - Remaining<V>(op, dst));
+                }
+            }
+        }
+
+        if ((step.flags & STEP_COMPLETES) && ++s.doneCount[p] == NUM_PIECES && !IsFinished(s, p)) {
+            s.finishPlace[p] = s.nextPlace++;
+            u.placed |= (uint8_t)(1u << p);
+            if (s.nextPlace == V::PLAYERS)
+                for (int op = 0; op < V::PLAYERS; ++op)
+                    if (!IsFinished(s, op)) { s.finishPlace[op] = s.nextPlace++; u.placed |= (uint8_t)(1u << op); }
+            for (int op = 0; op < V::PLAYERS; ++op)
+                if ((u.placed >> op) & 1) f.zobrist ^= z.place[op][s.finishPlace[op]];
+        }
+
+        // Threats only changed around the two squares the move touched.
+        uint64_t touched = Reach<V>(from) | Reach<V>(dst);
+        for (int op = 0; op < V::PLAYERS; ++op)
+            if (op == p || ((u.hit >> op) & 1) || (s.occ[op] & touched)) f.stale |= (uint8_t)(1u << op);
+
+        if (mv.dice != 6 || IsFinished(s, p)) AdvanceTurn(s);
+    }
+    else AdvanceTurn(s);
+    f.zobrist ^= z.turn[u.current] ^ z.turn[s.current];
+}
+
+template <class V>
+void RefreshExposure(const BasicGameState<V>& s, BasicEvalFeatures<V>& f) {
+    if (!f.stale) return;
+    CountExposed(s, f, f.stale);
+    f.stale = 0;
+}
+
+template <class V>
+void UnmakeMove(BasicGameState<V>& s, BasicEvalFeatures<V>& f, const BasicUndoRecord<V>& u) {
+    f = u.features;
+    s.current = u.current;
+    s.nextPlace = u.nextPlace;
+    if (u.move.piece == PASS) return;
+
+    int p = u.current, from = u.from, dst = s.sq[p][u.move.piece];
+    for (int op = 0; (u.hit | u.placed) >> op; ++op) {
+        if ((u.placed >> op) & 1) s.finishPlace[op] = 0;
+        if (!((u.hit >> op) & 1)) continue;
+        for (int i = 0; i < NUM_PIECES; ++i)
+            if ((u.captured[op] >> i) & 1) { s.sq[op][i] = (int8_t)dst; s.baseCount[op]--; }
+        s.occ[op] |= SquareBit(dst);
+    }
+
+    s.sq[p][u.move.piece] = (int8_t)from;
+    if (dst == V::HOME_STOP) s.doneCount[p]--;
+    bool stacked = false;
+    for (int i = 0; i < NUM_PIECES; ++i) stacked |= (i != u.move.piece && s.sq[p][i] == dst);
+    if (!stacked) s.occ[p] &= ~SquareBit(dst);
+    if (from == IN_BASE) s.baseCount[p]++;
+    else s.occ[p] |= SquareBit(from);
+}
+
+// =================== SELF-CHECK =================
+// The pre-table rules, one cell at a time: a piece is in base, on the loop
+// at outerIdx, or in its strip at finalIdx.
+template <class V>
+static int LegacyDestination(int player, int sq, int dice, bool& entersHome) {
+    entersHome = false;
+    if (sq == IN_BASE) return dice == 6 ? V::START[player] : -1;
+    if (sq >= V::LOOP_LEN) {
+        int nf = (sq - V::LOOP_LEN) + dice;
+        return nf > V::FINAL_LEN - 1 ? -1 : V::LOOP_LEN + nf;
+    }
+    int ni = sq + dice;
+    if (ni < V::LOOP_LEN) return ni;
+    int excess = ni - (V::LOOP_LEN - 1);          // 1..6 to enter final
+    if (excess < 1 || excess > V::FINAL_LEN) return -1;
+    entersHome = true;
+    return V::LOOP_LEN + excess - 1;
+}
+
+template <class V>
+static bool LegacyIsSafeSquare(int sq) {
+    if ((V::EXTRA_SAFE >> sq) & 1ull) return true;
+    for (int p = 0; p < V::PLAYERS; ++p)
+        if (sq == V::START[p]) return true;
+    return false;
+}
+
+static const size_t MAX_VERIFY_PLIES = 20000;
+
+template <class V>
+static bool SameFeatures(const BasicGameState<V>& s, BasicEvalFeatures<V> a, BasicEvalFeatures<V> b) {
+    RefreshExposure(s, a);
+    RefreshExposure(s, b);
+    if (a.zobrist != b.zobrist) return false;
+    for (int p = 0; p < V::PLAYERS; ++p)
+        if (a.distance[p] != b.distance[p] || a.exposedProgress[p] != b.exposedProgress[p]
+            || a.exposed[p] != b.exposed[p] || a.safe[p] != b.safe[p]) return false;
+    return true;
+}
+
+template <class V>
+int VerifyMakeUnmake(int games) {
+    int bad = 0;
+    std::vector<BasicUndoRecord<V>> undo;
+    for (int g = 0; g < games; ++g) {
+        CounterRng rng(0x4D414B45ull, (uint64_t)g);
+        const BasicGameState<V> start = NewGame<V>();
+        BasicGameState<V> s = start;
+        BasicEvalFeatures<V> f = ComputeFeatures(s);
+        undo.clear();
+        while (!IsGameOver(s) && undo.size() < MAX_VERIFY_PLIES) {
+            int d = rng.RollDice();
+            MoveList legal = LegalMoves(s, d);
+            Move mv = legal.empty() ? Move{ (int8_t)PASS, (uint8_t)d } : legal.m[rng.Below((uint32_t)legal.count)];
+            BasicGameState<V> want = ApplyMove(s, mv);
+            RefreshExposure(s, f);                  // so the stale marks of this move alone are tested
+            BasicEvalFeatures<V> before = f;
+            BasicGameState<V> was = s;
+
+            // Make, unmake and make again: both directions must be exact.
+            undo.emplace_back();
+            MakeMove(s, f, mv, undo.back());
+            UnmakeMove(s, f, undo.back());
+            bad += std::memcmp(&s, &was, sizeof(s)) != 0 || !SameFeatures(s, f, before);
+            MakeMove(s, f, mv, undo.back());
+            bad += std::memcmp(&s, &want, sizeof(s)) != 0 || !SameFeatures(s, f, ComputeFeatures(s));
+        }
+        // Unwinding the whole game lands back on the opening position.
+        while (!undo.empty()) { UnmakeMove(s, f, undo.back()); undo.pop_back(); }
+        bad += std::memcmp(&s, &start, sizeof(s)) != 0 || !SameFeatures(s, f, ComputeFeatures(start));
+    }
+    return bad;
+}
+
+template <class V>
+int VerifyStepTables() {
+    int bad = 0;
+    for (int p = 0; p < V::PLAYERS; ++p)
+        for (int sq = IN_BASE; sq <= V::HOME_STOP; ++sq)
+            for (int d = 1; d <= 6; ++d) {
+                bool enters;
+                int want = LegacyDestination<V>(p, sq, d, enters);
+                const StepEntry& e = StepFor<V>(p, sq, d);
+                if (e.dest != want) { ++bad; continue; }
+                if (want < 0) { bad += e.flags != 0; continue; }
+                bool onLoop = want < V::LOOP_LEN;
+                bool safe = onLoop && LegacyIsSafeSquare<V>(want);
+                bad += ((e.flags & STEP_SAFE) != 0) != safe;
+                bad += ((e.flags & STEP_CAPTURES) != 0) != (onLoop && !safe);
+                bad += ((e.flags & STEP_ENTERS_HOME) != 0) != enters;
+                bad += ((e.flags & STEP_COMPLETES) != 0) != (want == V::HOME_STOP);
+                bad += ((e.flags & STEP_SPAWN) != 0) != (sq == IN_BASE);
+            }
+    return bad;
+}
+
+// =================== VARIANTS ===================
+#define LUDO_INSTANTIATE_ENGINE(V)                                                  \
+    template BasicGameState<V> NewGame<V>();                                        \
+    template void RebuildOccupancy<V>(BasicGameState<V>&);                          \
+    template MoveList LegalMoves<V>(const BasicGameState<V>&, int);                 \
+    template BasicGameState<V> ApplyMove<V>(const BasicGameState<V>&, Move);        \
+    template uint64_t HashState<V>(const BasicGameState<V>&);                       \
+    template uint64_t ZobristHash<V>(const BasicGameState<V>&);                     \
+    template BasicEvalFeatures<V> ComputeFeatures<V>(const BasicGameState<V>&);     \
+    template void MakeMove<V>(BasicGameState<V>&, BasicEvalFeatures<V>&, Move, BasicUndoRecord<V>&); \
+    template void UnmakeMove<V>(BasicGameState<V>&, BasicEvalFeatures<V>&, const BasicUndoRecord<V>&); \
+    template void RefreshExposure<V>(const BasicGameState<V>&, BasicEvalFeatures<V>&); \
+    template int VerifyMakeUnmake<V>(int);                                          \
+    template int VerifyStepTables<V>();
+
+LUDO_INSTANTIATE_ENGINE(ClassicBoard)
+LUDO_INSTANTIATE_ENGINE(DuelBoard)
+LUDO_INSTANTIATE_ENGINE(SixBoard)
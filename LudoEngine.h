@@ -0,0 +1,167 @@
+#pragma once
+// Headless Ludo rules engine. No raylib, no globals: a game is a small
+// trivially-copyable GameState and the rules are pure functions over it.
+//
+// Everything is a template over the board variant (LudoBoard.h) and is
+// instantiated once per variant in LudoEngine.cpp. GameState, NewGame()
+// and the square helpers default to the classic four-seat board.
+#include <cstddef>
+#include <type_traits>
+
+#include "LudoBoard.h"
+
+static const int PASS = -1;                    // Move::piece when nothing is legal
+static const int FIRST_PLAYER = ClassicBoard::FIRST_PLAYER;   // YOU (RED) open the game
+
+// =================== STATE ======================
+// Square numbering shared by all players:
+//   IN_BASE               piece still sitting in its home quadrant
+//   0 .. LOOP_LEN-1       outerIdx on the loop
+//   LOOP_LEN .. HOME_STOP own home strip, finalIdx = sq - LOOP_LEN
+// Because the loop does not wrap, a move from the board is simply
+// sq + dice, legal as long as it does not overshoot HOME_STOP.
+//
+// occ/baseCount/doneCount mirror sq[] and are kept in step by ApplyMove:
+// bit `sq` of occ[p] is set while any piece of p stands on that square,
+// so captures, stacking and win checks are bit tests instead of scans.
+template <class V>
+struct BasicGameState {
+    static constexpr int PLAYERS = V::PLAYERS;
+    static constexpr int FIELD_BYTES = PLAYERS * (8 + NUM_PIECES + 3) + 2;
+    static constexpr int PAD = 8 - FIELD_BYTES % 8;   // 1..8, keeps the size a multiple of 8
+
+    uint64_t occ[PLAYERS];                  // bits 0..HOME_STOP, loop then home strip
+    int8_t  sq[PLAYERS][NUM_PIECES];
+    uint8_t baseCount[PLAYERS];             // pieces still in base
+    uint8_t doneCount[PLAYERS];             // pieces on the home stop
+    uint8_t finishPlace[PLAYERS];           // 0 = still playing
+    uint8_t current;                        // seat to move
+    uint8_t nextPlace;                      // next finish place to hand out (1-based)
+    uint8_t pad[PAD];                       // explicit, zeroed: raw-byte hashing stays well-defined
+};
+
+using GameState = BasicGameState<ClassicBoard>;
+
+template <class V>
+constexpr bool StateHasNoHiddenPadding() {
+    using S = BasicGameState<V>;
+    return std::is_trivially_copyable<S>::value && sizeof(S) == (size_t)(S::FIELD_BYTES + S::PAD);
+}
+
+static_assert(StateHasNoHiddenPadding<ClassicBoard>() && StateHasNoHiddenPadding<DuelBoard>()
+              && StateHasNoHiddenPadding<SixBoard>(), "GameState must stay memcpy-able with no hidden padding");
+static_assert(sizeof(GameState) == 64, "the classic GameState should stay one cache line");
+
+static const uint64_t LOOP_MASK = ClassicBoard::LOOP_MASK;
+
+struct Move {
+    int8_t  piece;                          // 0..3, or PASS
+    uint8_t dice;                           // 1..6
+};
+
+// Fixed-capacity move list: at most one move per piece, never allocates.
+struct MoveList {
+    Move m[NUM_PIECES];
+    int  count = 0;
+
+    bool empty() const { return count == 0; }
+    const Move* begin() const { return m; }
+    const Move* end() const { return m + count; }
+    bool Contains(int piece) const {
+        for (int i = 0; i < count; ++i) if (m[i].piece == piece) return true;
+        return false;
+    }
+};
+
+// =================== RULES ======================
+template <class V = ClassicBoard>
+inline bool IsOnLoop(int sq) { return sq >= 0 && sq < V::LOOP_LEN; }
+template <class V = ClassicBoard>
+inline bool IsInFinal(int sq) { return sq >= V::LOOP_LEN; }
+template <class V = ClassicBoard>
+inline bool IsSafeSquare(int sq) { return IsOnLoop<V>(sq) && ((SAFE_MASK<V> >> sq) & 1ull); }
+template <class V>
+inline bool IsFinished(const BasicGameState<V>& s, int player) { return s.finishPlace[player] != 0; }
+template <class V>
+inline bool IsGameOver(const BasicGameState<V>& s) { return s.nextPlace > V::PLAYERS; }
+inline uint64_t SquareBit(int sq) { return 1ull << sq; }
+
+// Pieces of `player` standing on `sq` (any player may stack).
+template <class V>
+inline bool Occupies(const BasicGameState<V>& s, int player, int sq) { return (s.occ[player] >> sq) & 1ull; }
+
+// True if the side to move has any legal move for `dice`, without building the list:
+// a spawn needs a six and a piece in base; a board piece needs room before HOME_STOP.
+template <class V>
+inline bool HasLegalMove(const BasicGameState<V>& s, int dice) {
+    int p = s.current;
+    if (dice == 6 && s.baseCount[p]) return true;
+    return (s.occ[p] & ((1ull << (V::HOME_STOP + 1 - dice)) - 1)) != 0;
+}
+
+// Destination square for a piece at `sq` rolling `dice`, or -1 when the move is illegal.
+template <class V = ClassicBoard>
+inline int DestinationOf(int player, int sq, int dice) { return StepFor<V>(player, sq, dice).dest; }
+
+template <class V = ClassicBoard>
+BasicGameState<V> NewGame();
+template <class V>
+void      RebuildOccupancy(BasicGameState<V>& s);    // after editing sq[] by hand
+template <class V>
+MoveList  LegalMoves(const BasicGameState<V>& s, int dice);
+template <class V>
+BasicGameState<V> ApplyMove(const BasicGameState<V>& s, Move mv);
+template <class V>
+uint64_t  HashState(const BasicGameState<V>& s);
+
+// Zobrist key over piece squares, side to move and finish places. XOR-
+// composable, so searches can update it move by move.
+template <class V>
+uint64_t  ZobristHash(const BasicGameState<V>& s);
+
+// =================== MAKE / UNMAKE ==============
+// Evaluation features kept in step with a state by MakeMove/UnmakeMove, so
+// a search can hash and score a node without rescanning its pieces. A piece
+// is exposed when it stands on a non-safe loop square 1..6 ahead of an
+// enemy piece; progress counts squares from base (START = 1). Exposure is
+// only recounted when it is read: MakeMove marks the seats whose threats
+// it changed and RefreshExposure recounts just those.
+template <class V>
+struct BasicEvalFeatures {
+    uint64_t zobrist;                       // ZobristHash() of the state
+    int16_t  distance[V::PLAYERS];          // squares left to HOME_STOP; a piece in base counts its whole path
+    int16_t  exposedProgress[V::PLAYERS];   // summed progress of the exposed pieces
+    uint8_t  exposed[V::PLAYERS];
+    uint8_t  safe[V::PLAYERS];              // pieces on safe loop squares
+    uint8_t  stale;                         // bit p: exposed/exposedProgress of p need a recount
+};
+
+// Everything MakeMove changed, so UnmakeMove restores the state exactly.
+template <class V>
+struct BasicUndoRecord {
+    BasicEvalFeatures<V> features;          // before the move
+    Move    move;
+    int8_t  from;                           // square the piece left
+    uint8_t current, nextPlace;             // before the move
+    uint8_t hit;                            // bit p: seat p lost pieces to a capture
+    uint8_t placed;                         // bit p: seat p was given its finish place
+    uint8_t captured[V::PLAYERS];           // seats in `hit`: bit i, piece i was sent home
+};
+
+using EvalFeatures = BasicEvalFeatures<ClassicBoard>;
+using UndoRecord = BasicUndoRecord<ClassicBoard>;
+
+template <class V>
+BasicEvalFeatures<V> ComputeFeatures(const BasicGameState<V>& s);   // from scratch
+// In-place ApplyMove for a legal move or a PASS. Features of seats the move
+// cannot have affected are left alone.
+template <class V>
+void MakeMove(BasicGameState<V>& s, BasicEvalFeatures<V>& f, Move mv, BasicUndoRecord<V>& undo);
+template <class V>
+void UnmakeMove(BasicGameState<V>& s, BasicEvalFeatures<V>& f, const BasicUndoRecord<V>& undo);
+template <class V>
+void RefreshExposure(const BasicGameState<V>& s, BasicEvalFeatures<V>& f);
+// Plays seeded random games through MakeMove/UnmakeMove and counts
+// disagreements with ApplyMove and ComputeFeatures.
+template <class V>
+int VerifyMakeUnmake(int games);
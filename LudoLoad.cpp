@@ -0,0 +1,201 @@
+// ludo_load: load generator for ludo_server.
+//
+//   ludo_load [--host H] [--port P] [--conns C] [--seats S] [--threads T] [--seconds N]
+//
+// Opens C bot connections (each asking for S seats, S = 1, 2 or 4, so a
+// table is 4/S connections), plays random legal moves as fast as the
+// server answers and rejoins when a game ends. Exits non-zero if no move
+// was played. Latency is measured per move, from sending MOVE to
+// receiving the server's next frame (the following TURN or GAME_OVER,
+// which the server only sends after validating and applying the move).
+// Linux only.
+#include "LudoNet.h"
+#include "LudoRandom.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct BotConn {
+    int fd = -1;
+    std::vector<uint8_t> in, out;
+    uint8_t seatMask = 0;
+    Clock::time_point sentAt;
+    bool awaiting = false;                      // a MOVE is in flight
+};
+
+struct alignas(64) LoadTally {
+    uint64_t moves = 0, games = 0, rejects = 0, failed = 0;
+    std::vector<uint32_t> latencyUs;
+};
+
+struct LoadConfig {
+    sockaddr_in addr{};
+    int conns = 400, seats = 1, threads = 1;
+    double seconds = 10.0;
+};
+
+template <class T>
+static void QueueMsg(BotConn& b, NetMsg type, const T& body) {
+    NetAppend(b.out, type, body);
+}
+
+static bool FlushBot(BotConn& b) {
+    size_t sent = 0;
+    while (sent < b.out.size()) {
+        ssize_t n = ::send(b.fd, b.out.data() + sent, b.out.size() - sent, MSG_NOSIGNAL);
+        if (n > 0) { sent += (size_t)n; continue; }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        return false;
+    }
+    b.out.erase(b.out.begin(), b.out.begin() + sent);
+    return true;
+}
+
+// One epoll loop driving `count` connections.
+static void RunBots(const LoadConfig& cfg, int worker, int count, Clock::time_point until, LoadTally& t) {
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    CounterRng rng(0x10AD, (uint64_t)worker, STREAM_AI);
+    std::vector<std::unique_ptr<BotConn>> bots;
+    for (int i = 0; i < count; ++i) {
+        std::unique_ptr<BotConn> b(new BotConn());
+        b->fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int one = 1;
+        setsockopt(b->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        if (::connect(b->fd, (const sockaddr*)&cfg.addr, sizeof(cfg.addr)) != 0 && errno != EINPROGRESS) {
+            t.failed++; ::close(b->fd); continue;
+        }
+        QueueMsg(*b, MSG_JOIN, MsgJoin{ NET_VERSION, (uint8_t)cfg.seats });
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLET;   // edge-triggered: reads drain, writes retry on the next edge
+        ev.data.ptr = b.get();
+        epoll_ctl(ep, EPOLL_CTL_ADD, b->fd, &ev);
+        bots.push_back(std::move(b));
+    }
+
+    epoll_event events[256];
+    while (Clock::now() < until) {
+        int n = epoll_wait(ep, events, 256, 50);
+        for (int i = 0; i < n; ++i) {
+            BotConn& b = *(BotConn*)events[i].data.ptr;
+            bool ok = !(events[i].events & (EPOLLERR | EPOLLHUP));
+            if (ok && (events[i].events & EPOLLIN)) {
+                uint8_t buf[4096];
+                ssize_t got;
+                while ((got = ::recv(b.fd, buf, sizeof(buf), 0)) > 0) b.in.insert(b.in.end(), buf, buf + got);
+                if (got == 0 || (got < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) ok = false;
+
+                Clock::time_point now = Clock::now();
+                size_t at = 0;
+                long len;
+                while (ok && (len = NetFrameLength(b.in.data() + at, b.in.size() - at)) > 0) {
+                    const uint8_t* frame = b.in.data() + at;
+                    at += (size_t)len;
+                    uint8_t type = frame[sizeof(uint16_t)];
+                    if (b.awaiting && type != MSG_WELCOME) {
+                        t.latencyUs.push_back((uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(now - b.sentAt).count());
+                        b.awaiting = false;
+                    }
+                    MsgWelcome w; MsgTurn tr; MsgGameOver go;
+                    if (type == MSG_WELCOME && NetBody(frame, len, w)) b.seatMask = w.seatMask;
+                    else if (type == MSG_TURN && NetBody(frame, len, tr)) {
+                        if (!(b.seatMask & (1 << tr.seat))) continue;
+                        uint8_t pieces[NUM_PIECES];
+                        int k = 0;
+                        for (int p = 0; p < NUM_PIECES; ++p) if (tr.legalMask & (1 << p)) pieces[k++] = (uint8_t)p;
+                        QueueMsg(b, MSG_MOVE, MsgMove{ tr.turn, pieces[rng.Below((uint32_t)k)] });
+                        b.sentAt = Clock::now();
+                        b.awaiting = true;
+                        t.moves++;
+                    }
+                    else if (type == MSG_GAME_OVER && NetBody(frame, len, go)) {
+                        t.games++;
+                        b.seatMask = 0;
+                        QueueMsg(b, MSG_JOIN, MsgJoin{ NET_VERSION, (uint8_t)cfg.seats });
+                    }
+                    else if (type == MSG_REJECT) t.rejects++;
+                }
+                if (ok && len < 0) ok = false;
+                b.in.erase(b.in.begin(), b.in.begin() + at);
+            }
+            if (ok && !b.out.empty()) ok = FlushBot(b);
+            if (!ok) { t.failed++; epoll_ctl(ep, EPOLL_CTL_DEL, b.fd, nullptr); ::close(b.fd); b.fd = -1; }
+        }
+    }
+    for (auto& b : bots) if (b->fd >= 0) ::close(b->fd);
+    ::close(ep);
+}
+
+static uint32_t Percentile(const std::vector<uint32_t>& sorted, double q) {
+    if (sorted.empty()) return 0;
+    size_t i = (size_t)(q * (sorted.size() - 1));
+    return sorted[i];
+}
+
+int main(int argc, char** argv) {
+    LoadConfig cfg;
+    const char* host = "127.0.0.1";
+    int port = NET_DEFAULT_PORT;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--host")) host = argv[i + 1];
+        else if (!strcmp(argv[i], "--port")) port = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--conns")) cfg.conns = std::max(1, atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--seats")) cfg.seats = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--threads")) cfg.threads = std::max(1, atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--seconds")) cfg.seconds = atof(argv[i + 1]);
+        else {
+            fprintf(stderr, "usage: %s [--host H] [--port P] [--conns C] [--seats S] [--threads T] [--seconds N]\n", argv[0]);
+            return 2;
+        }
+    }
+    // The server seats every JOIN at one table, so only seat counts that
+    // divide NUM_PLAYERS ever fill a table (3 would leave a seat nobody asks for).
+    if (cfg.seats < 1 || cfg.seats > NUM_PLAYERS || NUM_PLAYERS % cfg.seats != 0) {
+        fprintf(stderr, "--seats takes 1, 2 or 4\n");
+        return 2;
+    }
+    cfg.addr.sin_family = AF_INET;
+    cfg.addr.sin_port = htons((uint16_t)port);
+    if (inet_pton(AF_INET, host, &cfg.addr.sin_addr) != 1) { fprintf(stderr, "bad host %s\n", host); return 2; }
+
+    std::vector<LoadTally> tallies(cfg.threads);
+    Clock::time_point start = Clock::now();
+    Clock::time_point until = start + std::chrono::microseconds((int64_t)(cfg.seconds * 1e6));
+    std::vector<std::thread> pool;
+    for (int w = 0; w < cfg.threads; ++w) {
+        int count = cfg.conns * (w + 1) / cfg.threads - cfg.conns * w / cfg.threads;
+        pool.emplace_back(RunBots, std::cref(cfg), w, count, until, std::ref(tallies[w]));
+    }
+    for (auto& th : pool) th.join();
+    double secs = std::chrono::duration<double>(Clock::now() - start).count();
+
+    LoadTally total;
+    for (LoadTally& t : tallies) {
+        total.moves += t.moves; total.games += t.games; total.rejects += t.rejects; total.failed += t.failed;
+        total.latencyUs.insert(total.latencyUs.end(), t.latencyUs.begin(), t.latencyUs.end());
+    }
+    std::sort(total.latencyUs.begin(), total.latencyUs.end());
+    printf("%d conns x %d seat(s), %.1f s\n", cfg.conns, cfg.seats, secs);
+    printf("moves %llu (%.0f moves/s), games %llu (%.1f games/s), rejects %llu, dropped conns %llu\n",
+        (unsigned long long)total.moves, total.moves / secs, (unsigned long long)total.games, total.games / secs,
+        (unsigned long long)total.rejects, (unsigned long long)total.failed);
+    printf("move latency us: p50 %u  p90 %u  p99 %u  p99.9 %u  max %u\n",
+        Percentile(total.latencyUs, 0.5), Percentile(total.latencyUs, 0.9), Percentile(total.latencyUs, 0.99),
+        Percentile(total.latencyUs, 0.999), total.latencyUs.empty() ? 0 : total.latencyUs.back());
+    if (total.moves == 0) fprintf(stderr, "no move was played (is ludo_server running on %s:%d?)\n", host, port);
+    return total.failed || total.moves == 0 ? 1 : 0;
+}
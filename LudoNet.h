@@ -0,0 +1,119 @@
+#pragma once
+// Wire protocol between ludo_server and its clients.
+//
+// TCP, little-endian, one frame per message:
+//
+//   uint16 length   bytes after this field (type + body)
+//   uint8  type     NetMsg
+//   body            the packed struct for that type
+//
+// A client sends JOIN asking for 1..4 seats and is placed at a table; the
+// table starts once all four seats are taken. The server rolls every die
+// and sends TURN (dice, legal pieces, full packed state) to everyone at
+// the table whenever a seated client has to choose. Rolls without a legal
+// move and seats whose client left are played by the server. The client
+// answers with MOVE, echoing the turn number; anything illegal, stale or
+// out of turn gets a REJECT and changes nothing.
+#include "LudoReplay.h"
+#include <cstring>
+#include <vector>
+
+static const uint16_t NET_DEFAULT_PORT = 7777;
+static const uint8_t  NET_VERSION = 1;
+static const size_t   NET_MAX_FRAME = 256;      // larger length fields close the connection
+
+enum NetMsg : uint8_t {
+    // client -> server
+    MSG_JOIN      = 1,
+    MSG_MOVE      = 2,
+    // server -> client
+    MSG_WELCOME   = 16,
+    MSG_TURN      = 17,
+    MSG_GAME_OVER = 18,
+    MSG_REJECT    = 19,
+};
+
+enum NetReject : uint8_t {
+    REJECT_BAD_MESSAGE,
+    REJECT_VERSION,
+    REJECT_ALREADY_SEATED,
+    REJECT_NOT_SEATED,
+    REJECT_NOT_YOUR_TURN,
+    REJECT_STALE_TURN,
+    REJECT_ILLEGAL_MOVE,
+};
+
+#pragma pack(push, 1)
+struct NetHeader {
+    uint16_t length;
+    uint8_t  type;
+};
+
+struct MsgJoin {
+    uint8_t version;                            // NET_VERSION
+    uint8_t seats;                              // 1..4 seats at the same table
+};
+
+struct MsgMove {
+    uint32_t turn;                              // MsgTurn::turn being answered
+    uint8_t  piece;
+};
+
+struct MsgWelcome {
+    uint32_t table;
+    uint8_t  seatMask;                          // bit p = this client plays seat p
+};
+
+struct MsgTurn {
+    uint32_t table;
+    uint32_t turn;                              // rolls taken so far at this table
+    uint8_t  seat;                              // who has to move
+    uint8_t  dice;
+    uint8_t  legalMask;                         // bit i = piece i may move
+    uint8_t  state[PACKED_STATE_BYTES];         // PackState() before the move
+};
+
+struct MsgGameOver {
+    uint32_t table;
+    uint32_t turns;
+    uint8_t  finishPlace[NUM_PLAYERS];
+};
+
+struct MsgReject {
+    uint32_t table;
+    uint8_t  reason;                            // NetReject
+};
+#pragma pack(pop)
+
+template <class T>
+void NetAppend(std::vector<uint8_t>& out, NetMsg type, const T& body) {
+    NetHeader h{ (uint16_t)(1 + sizeof(T)), (uint8_t)type };
+    size_t at = out.size();
+    out.resize(at + sizeof(h) + sizeof(T));
+    std::memcpy(&out[at], &h, sizeof(h));
+    std::memcpy(&out[at + sizeof(h)], &body, sizeof(T));
+}
+
+// Length of the first complete frame in buf (header included), 0 if more
+// bytes are needed, or -1 if the stream is garbage.
+inline long NetFrameLength(const uint8_t* buf, size_t n) {
+    if (n < sizeof(uint16_t)) return 0;
+    uint16_t len;
+    std::memcpy(&len, buf, sizeof(len));
+    if (len < 1 || len > NET_MAX_FRAME) return -1;
+    return (n >= sizeof(uint16_t) + len) ? (long)(sizeof(uint16_t) + len) : 0;
+}
+
+// Body of a frame of the expected type and size, or false.
+template <class T>
+bool NetBody(const uint8_t* frame, long frameLen, T& out) {
+    if (frameLen != (long)(sizeof(NetHeader) + sizeof(T))) return false;
+    std::memcpy(&out, frame + sizeof(NetHeader), sizeof(T));
+    return true;
+}
+
+inline uint8_t LegalMask(const MoveList& legal) {
+    uint8_t m = 0;
+    for (const Move& mv : legal) m |= (uint8_t)(1u << mv.piece);
+    return m;
+}
@@ -0,0 +1,246 @@
+#include "LudoOdds.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+
+template <class V>
+uint64_t CanonicalKey(const BasicGameState<V>& s) {
+    uint64_t h = Mix64(0x0DD5ull + s.current);
+    for (int p = 0; p < V::PLAYERS; ++p) {
+        int8_t q[NUM_PIECES];
+        std::copy(s.sq[p], s.sq[p] + NUM_PIECES, q);
+        std::sort(q, q + NUM_PIECES);
+        uint64_t word = (uint64_t)s.finishPlace[p] << 32;
+        for (int i = 0; i < NUM_PIECES; ++i) word |= (uint64_t)(uint8_t)q[i] << (8 * i);
+        h = Mix64(h ^ word);
+    }
+    return h ? h : 1;
+}
+
+// =================== RACES ======================
+template <class V>
+BasicRaceOdds<V>::BasicRaceOdds() {
+    // Distance tuples, most significant first; only sorted ones get a row.
+    auto decode = [](int code, int d[NUM_PIECES]) {
+        for (int i = NUM_PIECES - 1; i >= 0; --i) { d[i] = code % F; code /= F; }
+    };
+    auto encode = [](int d[NUM_PIECES]) {
+        std::sort(d, d + NUM_PIECES);
+        int code = 0;
+        for (int i = 0; i < NUM_PIECES; ++i) code = code * F + d[i];
+        return code;
+    };
+    std::vector<int> order;
+    for (int code = 0; code < CODES; ++code) {
+        int d[NUM_PIECES];
+        decode(code, d);
+        bool sorted = std::is_sorted(d, d + NUM_PIECES);
+        row[code] = sorted ? (int16_t)order.size() : (int16_t)-1;
+        if (sorted) order.push_back(code);
+    }
+    // Every move shortens the total distance, so solving in order of
+    // increasing sum only ever reads finished rows (and the row itself
+    // for a passed turn).
+    auto sum = [&](int code) { int d[NUM_PIECES]; decode(code, d); return d[0] + d[1] + d[2] + d[3]; };
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return sum(a) < sum(b); });
+
+    const int T = RACE_TURNS + 1;
+    std::vector<double> expected(order.size(), 0.0);
+    survive.assign(order.size() * T, 0.0f);
+    for (int code : order) {
+        int r = row[code];
+        if (sum(code) == 0) continue;           // home: never "not home"
+        int d[NUM_PIECES];
+        decode(code, d);
+        // Best successor per face (the fewest expected turns left), -1 = pass.
+        int next[6], passes = 0;
+        double e = 1.0;
+        for (int k = 1; k <= 6; ++k) {
+            next[k - 1] = -1;
+            double best = 1e30;
+            for (int i = 0; i < NUM_PIECES; ++i) {
+                if (d[i] < k) continue;
+                int n[NUM_PIECES] = { d[0], d[1], d[2], d[3] };
+                n[i] -= k;
+                int nr = row[encode(n)];
+                if (expected[nr] < best) { best = expected[nr]; next[k - 1] = nr; }
+            }
+            if (next[k - 1] < 0) ++passes;
+            else e += best / 6.0;
+        }
+        expected[r] = e / (1.0 - passes / 6.0);
+
+        float* sv = &survive[(size_t)r * T];
+        sv[0] = 1.0f;
+        for (int t = 1; t < T; ++t) {
+            double p = passes / 6.0 * sv[t - 1];
+            for (int k = 0; k < 6; ++k)
+                if (next[k] >= 0) p += survive[(size_t)next[k] * T + t - 1] / 6.0;
+            sv[t] = (float)p;
+        }
+    }
+}
+
+template <class V>
+int BasicRaceOdds<V>::Row(const BasicGameState<V>& s, int p) const {
+    int d[NUM_PIECES];
+    for (int i = 0; i < NUM_PIECES; ++i) d[i] = V::HOME_STOP - s.sq[p][i];
+    std::sort(d, d + NUM_PIECES);
+    return row[((d[0] * F + d[1]) * F + d[2]) * F + d[3]];
+}
+
+// A seat's t-th turn comes after the t-th turns of the seats before it in
+// turn order and after the (t-1)-th of those behind it.
+template <class V>
+bool BasicRaceOdds<V>::Probe(const BasicGameState<V>& s, float chance[V::PLAYERS]) const {
+    if (IsGameOver(s)) return false;
+    const float* sv[V::PLAYERS];
+    int seats[V::PLAYERS], n = 0;
+    for (int k = 0; k < V::PLAYERS; ++k) {
+        int p = (s.current + k) % V::PLAYERS;
+        if (IsFinished(s, p)) continue;
+        if (s.baseCount[p] || (s.occ[p] & V::LOOP_MASK)) return false;
+        seats[n] = p;
+        sv[n++] = &survive[(size_t)Row(s, p) * (RACE_TURNS + 1)];
+    }
+    for (int p = 0; p < V::PLAYERS; ++p) chance[p] = 0.0f;
+    double total = 0.0;
+    for (int j = 0; j < n; ++j) {
+        double acc = 0.0;
+        for (int t = 1; t <= RACE_TURNS; ++t) {
+            double pj = (double)sv[j][t - 1] - sv[j][t];
+            if (pj <= 0.0) continue;
+            for (int i = 0; i < n; ++i) if (i != j) pj *= sv[i][i < j ? t : t - 1];
+            acc += pj;
+        }
+        chance[seats[j]] = (float)acc;
+        total += acc;
+    }
+    if (total > 0.0)
+        for (int p = 0; p < V::PLAYERS; ++p) chance[p] = (float)(chance[p] / total);
+    return true;
+}
+
+// =================== ROLLOUTS ===================
+// Greedy play until the next place is handed out or a race is reached.
+// Rollout i of a position draws from the streams (key, i), so an estimate
+// does not depend on which thread played what.
+template <class V>
+static void Rollout(const BasicRaceOdds<V>& race, BasicGameState<V> s, uint64_t key, uint64_t i,
+                    double sum[V::PLAYERS]) {
+    CounterRng dice(key, i, STREAM_DICE), ai(key, i, STREAM_AI);
+    const AiWeights greedy;
+    const int place = s.nextPlace;
+    float chance[V::PLAYERS];
+    for (uint32_t ply = 0; ply < MAX_PLIES; ++ply) {
+        if (race.Probe(s, chance)) {
+            for (int p = 0; p < V::PLAYERS; ++p) sum[p] += chance[p];
+            return;
+        }
+        int d = dice.RollDice();
+        MoveList legal = LegalMoves(s, d);
+        s = ApplyMove(s, legal.empty() ? Move{ (int8_t)PASS, (uint8_t)d } : PickGreedyMove(s, legal, greedy, ai));
+        if (s.nextPlace != place) {
+            for (int p = 0; p < V::PLAYERS; ++p) sum[p] += s.finishPlace[p] == place;
+            return;
+        }
+    }
+}
+
+// =================== METER ======================
+template <class V>
+BasicOddsMeter<V>::BasicOddsMeter(int threads)
+    : cache(ODDS_CACHE_SLOTS), threadCount(threads > 0 ? threads : std::max(1, DefaultThreadCount() - 1)) {}
+
+template <class V>
+BasicOddsMeter<V>::~BasicOddsMeter() {
+    {
+        std::lock_guard<std::mutex> lk(m);
+        quit = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : pool) t.join();
+}
+
+template <class V>
+const OddsEstimate& BasicOddsMeter<V>::Update(const State& s) {
+    uint64_t key = CanonicalKey(s);
+    OddsEstimate& slot = cache[key & (ODDS_CACHE_SLOTS - 1)];
+    if (key != current.key) {
+        current = OddsEstimate();
+        current.key = key;
+        if (IsGameOver(s)) Stop();
+        else if (race.Probe(s, current.chance)) { current.exact = true; Stop(); }
+        else if (slot.key == key) { current = slot; Stop(); }
+        else Start(s, key);
+        return current;
+    }
+    if (current.exact || current.samples >= ODDS_MAX_SAMPLES || IsGameOver(s)) return current;
+
+    std::unique_lock<std::mutex> lk(m, std::try_to_lock);
+    if (!lk.owns_lock() || jobKey != key || done < ODDS_MIN_SAMPLES || done == current.samples) return current;
+    double total = 0.0;
+    for (int p = 0; p < V::PLAYERS; ++p) total += wins[p];
+    for (int p = 0; p < V::PLAYERS; ++p) current.chance[p] = total > 0.0 ? (float)(wins[p] / total) : 0.0f;
+    current.samples = done;
+    if (done >= ODDS_MAX_SAMPLES) slot = current;
+    return current;
+}
+
+template <class V>
+void BasicOddsMeter<V>::Start(const State& s, uint64_t key) {
+    {
+        std::lock_guard<std::mutex> lk(m);
+        job = s;
+        jobKey = key;
+        ++generation;
+        claimed = done = 0;
+        for (int p = 0; p < V::PLAYERS; ++p) wins[p] = 0.0;
+    }
+    if (pool.empty())
+        for (int t = 0; t < threadCount; ++t) pool.emplace_back(&BasicOddsMeter<V>::Run, this);
+    wake.notify_all();
+}
+
+template <class V>
+void BasicOddsMeter<V>::Stop() {
+    std::lock_guard<std::mutex> lk(m);
+    ++generation;
+    jobKey = 0;
+    claimed = ODDS_MAX_SAMPLES;
+}
+
+template <class V>
+void BasicOddsMeter<V>::Run() {
+    for (;;) {
+        State s;
+        uint64_t key, gen;
+        uint32_t first, n;
+        {
+            std::unique_lock<std::mutex> lk(m);
+            wake.wait(lk, [&] { return quit || claimed < ODDS_MAX_SAMPLES; });
+            if (quit) return;
+            s = job;
+            key = jobKey;
+            gen = generation;
+            first = claimed;
+            n = std::min(ODDS_CHUNK, ODDS_MAX_SAMPLES - claimed);
+            claimed += n;
+        }
+        double sum[V::PLAYERS] = {};
+        for (uint32_t i = first; i < first + n; ++i) Rollout(race, s, key, i, sum);
+        std::lock_guard<std::mutex> lk(m);
+        if (gen != generation) continue;
+        for (int p = 0; p < V::PLAYERS; ++p) wins[p] += sum[p];
+        done += n;
+    }
+}
+
+// =================== VARIANTS ===================
+#define LUDO_INSTANTIATE_ODDS(V)                                    \
+    template uint64_t CanonicalKey<V>(const BasicGameState<V>&);    \
+    template class BasicRaceOdds<V>;                                \
+    template class BasicOddsMeter<V>;
+
+LUDO_INSTANTIATE_ODDS(ClassicBoard)
+LUDO_INSTANTIATE_ODDS(DuelBoard)
+LUDO_INSTANTIATE_ODDS(SixBoard)
@@ -0,0 +1,100 @@
+#pragma once
+// Live win chances for the sidebar meter.
+//
+// The meter shows each unfinished seat's chance of taking the next open
+// place (first place while nobody has finished).
+//
+// Races are exact. A race is a position where every unfinished piece
+// already stands in its home strip. Nobody can be hit any more, so each
+// seat is an independent Markov chain over the multiset of its distances
+// to home. RaceOdds tabulates once per variant how many turns each such
+// multiset needs, playing the move that leaves the fewest expected turns.
+// The chances then follow from those distributions taken in turn order.
+//
+// Positions with contact are estimated by Monte-Carlo rollouts of the
+// greedy policy on a few background threads, up to ODDS_MAX_SAMPLES per
+// position. A rollout that reaches a race stops and scores it exactly.
+// OddsMeter keeps finished estimates in a fixed-size cache keyed by
+// CanonicalKey(), which ignores which piece of a seat stands where.
+// Update() never waits on the threads and allocates nothing.
+#include "LudoAi.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static const int RACE_TURNS = 256;                  // longest race tabulated; the tail beyond is below 1e-18
+static const uint32_t ODDS_MAX_SAMPLES = 4096;      // rollouts per position
+static const uint32_t ODDS_MIN_SAMPLES = 64;        // before a rollout estimate is shown
+static const uint32_t ODDS_CHUNK = 32;              // rollouts a thread claims at a time
+static const size_t ODDS_CACHE_SLOTS = 4096;        // a power of two
+
+struct OddsEstimate {
+    uint64_t key = 0;                   // CanonicalKey() of the position, 0 = none yet
+    float    chance[MAX_SEATS] = {};    // of taking the next open place; finished seats 0
+    uint32_t samples = 0;               // rollouts behind `chance`
+    bool     exact = false;             // a race, read from RaceOdds
+};
+
+// Position key that sorts each seat's squares, so positions that only
+// differ in which piece is where share a key. Covers side to move and
+// finish places. Never 0.
+template <class V>
+uint64_t CanonicalKey(const BasicGameState<V>& s);
+
+template <class V>
+class BasicRaceOdds {
+public:
+    BasicRaceOdds();
+    // Exact chances if every unfinished seat is racing in its home strip.
+    bool Probe(const BasicGameState<V>& s, float chance[V::PLAYERS]) const;
+
+private:
+    static constexpr int F = V::FINAL_LEN;
+    static constexpr int CODES = F * F * F * F;
+    static_assert(NUM_PIECES == 4, "race multisets are enumerated for four pieces");
+    static_assert(F <= 6, "a six never moves in the home strip, so a race turn is one roll");
+
+    int Row(const BasicGameState<V>& s, int p) const;
+
+    int16_t row[CODES];                 // sorted distance tuple (base F) -> row; -1 if not sorted
+    std::vector<float> survive;         // row * (RACE_TURNS + 1) + t: P(not home after t own turns)
+};
+
+template <class V>
+class BasicOddsMeter {
+public:
+    using State = BasicGameState<V>;
+
+    explicit BasicOddsMeter(int threads = 0);   // 0: all cores but one, at least one
+    ~BasicOddsMeter();
+    BasicOddsMeter(const BasicOddsMeter&) = delete;
+    BasicOddsMeter& operator=(const BasicOddsMeter&) = delete;
+
+    // The estimate for `s`, refined on each call while rollouts come in.
+    // Cheap; meant to be called every frame.
+    const OddsEstimate& Update(const State& s);
+
+private:
+    void Start(const State& s, uint64_t key);
+    void Stop();
+    void Run();
+
+    BasicRaceOdds<V> race;
+    std::vector<OddsEstimate> cache;    // finished estimates, direct-mapped by key
+    OddsEstimate current;
+    int threadCount;
+    std::vector<std::thread> pool;      // started with the first rollout job
+
+    std::mutex m;
+    std::condition_variable wake;
+    State job;                          // position the pool is sampling
+    uint64_t jobKey = 0;
+    uint64_t generation = 0;            // bumped per job; late chunks of older jobs are dropped
+    uint32_t claimed = ODDS_MAX_SAMPLES, done = 0;
+    double wins[V::PLAYERS] = {};
+    bool quit = false;
+};
+
+using RaceOdds = BasicRaceOdds<ClassicBoard>;
+using OddsMeter = BasicOddsMeter<ClassicBoard>;
@@ -0,0 +1,38 @@
+#pragma once
+// Counter-based dice generator. Every draw is a pure function of
+// (key, counter), so a game seeded from (seed, gameIndex) replays the same
+// rolls on any thread, in any order, with any number of workers.
+#include <cstdint>
+
+constexpr uint64_t Mix64(uint64_t z) {
+    // SplitMix64 finalizer
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Independent streams per game: dice and AI tie-breaks never share draws,
+// so swapping a policy does not change the dice a seat is dealt.
+enum RngStream : uint64_t { STREAM_DICE = 1, STREAM_AI = 2 };
+
+struct CounterRng {
+    uint64_t key = 0;
+    uint64_t counter = 0;
+
+    CounterRng() = default;
+    CounterRng(uint64_t seed, uint64_t gameIndex, uint64_t stream = STREAM_DICE)
+        : key(Mix64(Mix64(seed) ^ Mix64(gameIndex * 4 + stream))), counter(0) {}
+
+    uint64_t Next() { return Mix64(key ^ Mix64(counter++)); }
+
+    // Uniform in [0, n) without modulo bias.
+    uint32_t Below(uint32_t n) {
+        uint64_t limit = UINT64_MAX - UINT64_MAX % n;
+        uint64_t x;
+        do { x = Next(); } while (x >= limit);
+        return (uint32_t)(x % n);
+    }
+
+    int RollDice() { return (int)Below(6) + 1; }
+};
@@ -0,0 +1,188 @@
+#include "LudoReplay.h"
+#include <cstring>
+
+// =================== ENCODING ===================
+void PackState(const GameState& s, uint8_t out[PACKED_STATE_BYTES]) {
+    std::memcpy(out, s.sq, NUM_PLAYERS * NUM_PIECES);
+    std::memcpy(out + NUM_PLAYERS * NUM_PIECES, s.finishPlace, NUM_PLAYERS);
+    out[PACKED_STATE_BYTES - 2] = s.current;
+    out[PACKED_STATE_BYTES - 1] = s.nextPlace;
+}
+
+GameState UnpackState(const uint8_t in[PACKED_STATE_BYTES]) {
+    GameState s = NewGame();
+    std::memcpy(s.sq, in, NUM_PLAYERS * NUM_PIECES);
+    std::memcpy(s.finishPlace, in + NUM_PLAYERS * NUM_PIECES, NUM_PLAYERS);
+    s.current = in[PACKED_STATE_BYTES - 2];
+    s.nextPlace = in[PACKED_STATE_BYTES - 1];
+    RebuildOccupancy(s);
+    return s;
+}
+
+void WriteReplayFileHeader(std::vector<uint8_t>& out) {
+    ReplayFileHeader h;
+    std::memcpy(h.magic, "LUDOREPL", 8);
+    h.version = REPLAY_VERSION;
+    h.keyframeInterval = REPLAY_KEYFRAME_INTERVAL;
+    h.keyframeBytes = REPLAY_KEYFRAME_BYTES;
+    h.reserved = 0;
+    const uint8_t* b = reinterpret_cast<const uint8_t*>(&h);
+    out.insert(out.end(), b, b + sizeof(h));
+}
+
+bool CheckReplayFileHeader(const uint8_t* data, size_t size, int& keyframeInterval) {
+    if (size < sizeof(ReplayFileHeader)) return false;
+    ReplayFileHeader h;
+    std::memcpy(&h, data, sizeof(h));
+    if (std::memcmp(h.magic, "LUDOREPL", 8) != 0 || h.version != REPLAY_VERSION) return false;
+    if (h.keyframeBytes != REPLAY_KEYFRAME_BYTES || h.keyframeInterval == 0) return false;
+    keyframeInterval = h.keyframeInterval;
+    return true;
+}
+
+void ReplayEncoder::BeginGame(uint64_t seed, uint64_t gameIndex) {
+    ReplayGameHeader h;
+    std::memset(&h, 0, sizeof(h));
+    h.magic = REPLAY_GAME_MAGIC;
+    h.seed = seed;
+    h.gameIndex = gameIndex;
+    headerAt = bytes.size();
+    turns = 0;
+    const uint8_t* b = reinterpret_cast<const uint8_t*>(&h);
+    bytes.insert(bytes.end(), b, b + sizeof(h));
+}
+
+void ReplayEncoder::Record(int player, Move mv, const GameState& after) {
+    bytes.push_back(EncodeTurn(player, mv.dice, mv.piece));
+    if (++turns % REPLAY_KEYFRAME_INTERVAL == 0) {
+        uint8_t packed[PACKED_STATE_BYTES];
+        PackState(after, packed);
+        bytes.push_back(REPLAY_KEYFRAME);
+        bytes.insert(bytes.end(), packed, packed + PACKED_STATE_BYTES);
+    }
+}
+
+void ReplayEncoder::EndGame() {
+    ReplayGameHeader h;
+    std::memcpy(&h, &bytes[headerAt], sizeof(h));
+    h.payloadBytes = (uint32_t)(bytes.size() - headerAt - sizeof(h));
+    h.turns = turns;
+    std::memcpy(&bytes[headerAt], &h, sizeof(h));
+}
+
+void ReplayEncoder::Rewind(uint32_t to) {
+    if (to >= turns) return;
+    size_t payload = to + (size_t)(to / REPLAY_KEYFRAME_INTERVAL) * REPLAY_KEYFRAME_BYTES;
+    bytes.resize(headerAt + sizeof(ReplayGameHeader) + payload);
+    turns = to;
+}
+
+// =================== FILE STREAM ================
+bool ReplayFileWriter::Open(const char* path) {
+    f = std::fopen(path, "wb");
+    if (!f) return false;
+    std::vector<uint8_t> hdr;
+    WriteReplayFileHeader(hdr);
+    std::fwrite(hdr.data(), 1, hdr.size(), f);
+    std::fflush(f);
+    return true;
+}
+
+void ReplayFileWriter::BeginGame(uint64_t seed, uint64_t gameIndex) {
+    if (!f) return;
+    enc.bytes.clear();
+    enc.BeginGame(seed, gameIndex);
+    rewound = false;
+    fileGameAt = std::ftell(f);
+    std::fwrite(enc.bytes.data(), 1, enc.bytes.size(), f);
+    std::fflush(f);
+    flushed = enc.bytes.size();
+}
+
+void ReplayFileWriter::Record(int player, Move mv, const GameState& after) {
+    if (!f) return;
+    enc.Record(player, mv, after);
+    std::fwrite(enc.bytes.data() + flushed, 1, enc.bytes.size() - flushed, f);
+    std::fflush(f);
+    flushed = enc.bytes.size();
+    if (rewound) EndGame();
+}
+
+void ReplayFileWriter::EndGame() {
+    if (!f) return;
+    enc.EndGame();
+    long end = std::ftell(f);
+    std::fseek(f, fileGameAt, SEEK_SET);
+    std::fwrite(enc.bytes.data(), 1, sizeof(ReplayGameHeader), f);
+    std::fseek(f, end, SEEK_SET);
+    std::fflush(f);
+}
+
+void ReplayFileWriter::Rewind(uint32_t turns) {
+    if (!f || turns >= enc.turns) return;
+    enc.Rewind(turns);
+    flushed = enc.bytes.size();
+    std::fseek(f, fileGameAt + (long)flushed, SEEK_SET);
+    rewound = true;
+    EndGame();
+}
+
+void ReplayFileWriter::Close() {
+    if (f) std::fclose(f);
+    f = nullptr;
+}
+
+// =================== READING ====================
+size_t NextReplayGame(const uint8_t* data, size_t size, size_t at, int keyframeInterval, ReplayGameView& out) {
+    if (at + sizeof(ReplayGameHeader) > size) return 0;
+    const ReplayGameHeader* h = reinterpret_cast<const ReplayGameHeader*>(data + at);
+    if (h->magic != REPLAY_GAME_MAGIC) return 0;
+    size_t start = at + sizeof(ReplayGameHeader);
+    out.header = h;
+    out.payload = data + start;
+    out.keyframeInterval = keyframeInterval;
+    if (h->payloadBytes != 0) {                 // finished: a game has at least one turn byte
+        out.payloadBytes = h->payloadBytes;
+        out.turns = h->turns;
+        if (start + out.payloadBytes > size) return 0;
+        // A damaged header must not send ReplayTurnByte()/SeekReplay() past the payload.
+        if (out.turns + (size_t)(out.turns / keyframeInterval) * REPLAY_KEYFRAME_BYTES > out.payloadBytes) return 0;
+    }
+    else {
+        // Cut short: everything up to EOF belongs to this game.
+        out.payloadBytes = size - start;
+        size_t block = (size_t)keyframeInterval + REPLAY_KEYFRAME_BYTES;
+        size_t rem = out.payloadBytes % block;
+        out.turns = (uint32_t)(out.payloadBytes / block * keyframeInterval + (rem < (size_t)keyframeInterval ? rem : keyframeInterval));
+    }
+    return start + out.payloadBytes;
+}
+
+uint8_t ReplayTurnByte(const ReplayGameView& g, uint32_t turn) {
+    return g.payload[turn + (size_t)(turn / g.keyframeInterval) * REPLAY_KEYFRAME_BYTES];
+}
+
+bool SeekReplay(const ReplayGameView& g, uint32_t turn, GameState& out) {
+    if (turn > g.turns) return false;
+    uint32_t k = turn / g.keyframeInterval;
+    while (k > 0 && KeyframeOffset(k, g.keyframeInterval) + REPLAY_KEYFRAME_BYTES > g.payloadBytes) --k;
+    uint32_t t = 0;
+    if (k > 0) {
+        size_t at = KeyframeOffset(k, g.keyframeInterval);
+        if (g.payload[at] != REPLAY_KEYFRAME) return false;
+        out = UnpackState(g.payload + at + 1);
+        t = k * g.keyframeInterval;
+    }
+    else {
+        out = NewGame();
+    }
+    for (; t < turn; ++t) {
+        int player, dice, piece;
+        DecodeTurn(ReplayTurnByte(g, t), player, dice, piece);
+        if (player != out.current) return false;
+        GameState next = ApplyMove(out, { (int8_t)piece, (uint8_t)dice });
+        if (piece != PASS && std::memcmp(&next, &out, sizeof(out)) == 0) return false;   // illegal move in log
+        out = next;
+    }
+    return true;
+}
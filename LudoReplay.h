@@ -0,0 +1,120 @@
+#pragma once
+// Compact binary replay logs.
+//
+// A file is a ReplayFileHeader followed by games. Each game is a
+// ReplayGameHeader plus a payload of one byte per turn:
+//
+//   bit 0-1 player, bit 2-4 dice-1, bit 5-7 piece (0..3, REPLAY_PASS)
+//
+// After every `keyframeInterval` turns the payload also carries a
+// REPLAY_KEYFRAME byte and a packed 22-byte state (squares, places, turn;
+// the occupancy mirrors are rebuilt on load), so keyframe k always sits at
+// byte k*K + (k-1)*REPLAY_KEYFRAME_BYTES and a seek never has to scan.
+// payloadBytes is patched when the game ends; a game that was cut short
+// (crash, or a window closed mid-game) keeps 0 and runs to the end of the
+// file.
+#include "LudoEngine.h"
+#include <cstdio>
+#include <vector>
+
+static const int REPLAY_VERSION = 1;
+static const int REPLAY_KEYFRAME_INTERVAL = 32;
+static const int REPLAY_PASS = 4;               // piece field of a roll with no legal move
+static const uint8_t REPLAY_KEYFRAME = 0xFF;    // dice field 7 never occurs in a turn byte
+static const int PACKED_STATE_BYTES = NUM_PLAYERS * NUM_PIECES + NUM_PLAYERS + 2;
+static const int REPLAY_KEYFRAME_BYTES = 1 + PACKED_STATE_BYTES;
+
+#pragma pack(push, 1)
+struct ReplayFileHeader {
+    char     magic[8];                          // "LUDOREPL"
+    uint16_t version;
+    uint16_t keyframeInterval;
+    uint16_t keyframeBytes;                     // REPLAY_KEYFRAME_BYTES of the writer
+    uint16_t reserved;
+};
+
+struct ReplayGameHeader {
+    uint32_t magic;                             // REPLAY_GAME_MAGIC
+    uint32_t payloadBytes;                      // 0 while the game is still being written
+    uint64_t seed;
+    uint64_t gameIndex;
+    uint32_t turns;
+    uint32_t reserved;
+};
+#pragma pack(pop)
+
+static const uint32_t REPLAY_GAME_MAGIC = 0x4D41474Cu;   // "LGAM"
+
+inline uint8_t EncodeTurn(int player, int dice, int piece) {
+    int pf = (piece == PASS) ? REPLAY_PASS : piece;
+    return (uint8_t)((pf << 5) | ((dice - 1) << 2) | player);
+}
+
+inline void DecodeTurn(uint8_t b, int& player, int& dice, int& piece) {
+    player = b & 3;
+    dice = ((b >> 2) & 7) + 1;
+    piece = b >> 5;
+    if (piece == REPLAY_PASS) piece = PASS;
+}
+
+void PackState(const GameState& s, uint8_t out[PACKED_STATE_BYTES]);
+GameState UnpackState(const uint8_t in[PACKED_STATE_BYTES]);
+
+// Byte offset of keyframe k (k >= 1) inside a game payload.
+inline size_t KeyframeOffset(uint32_t k, int interval) {
+    return (size_t)k * interval + (size_t)(k - 1) * REPLAY_KEYFRAME_BYTES;
+}
+
+// Appends one game to an in-memory buffer.
+struct ReplayEncoder {
+    std::vector<uint8_t> bytes;
+    size_t   headerAt = 0;
+    uint32_t turns = 0;
+
+    void BeginGame(uint64_t seed, uint64_t gameIndex);
+    void Record(int player, Move mv, const GameState& after);
+    void EndGame();                             // patches payloadBytes and turns
+    void Rewind(uint32_t turns);                // drops the turns after `turns` (a take-back)
+};
+
+// Streams a game to disk turn by turn (flushed after every turn).
+struct ReplayFileWriter {
+    FILE*  f = nullptr;
+    ReplayEncoder enc;
+    size_t flushed = 0;
+    long   fileGameAt = 0;
+
+    bool Open(const char* path);                // writes the file header
+    void BeginGame(uint64_t seed, uint64_t gameIndex);
+    void Record(int player, Move mv, const GameState& after);
+    void EndGame();
+    // Take-back: later turns are overwritten as play goes on. From then on
+    // every turn also patches the game header, so a game cut short still
+    // ends at its last real turn rather than in stale bytes.
+    void Rewind(uint32_t turns);
+    void Close();
+
+    bool rewound = false;
+};
+
+void WriteReplayFileHeader(std::vector<uint8_t>& out);
+bool CheckReplayFileHeader(const uint8_t* data, size_t size, int& keyframeInterval);
+
+// Zero-copy view of one game inside a mapped or loaded file.
+struct ReplayGameView {
+    const ReplayGameHeader* header = nullptr;
+    const uint8_t* payload = nullptr;
+    size_t payloadBytes = 0;
+    uint32_t turns = 0;                         // counted from the payload if the game was cut short
+    int keyframeInterval = REPLAY_KEYFRAME_INTERVAL;
+};
+
+// Walks game headers; returns the offset of the next game or 0 at the end.
+size_t NextReplayGame(const uint8_t* data, size_t size, size_t at, int keyframeInterval, ReplayGameView& out);
+
+// State after `turn` turns: nearest keyframe, then the remaining turns
+// through ApplyMove. Returns false if the log is inconsistent.
+bool SeekReplay(const ReplayGameView& g, uint32_t turn, GameState& out);
+
+// Turn byte of the given turn (0-based) without walking the payload.
+uint8_t ReplayTurnByte(const ReplayGameView& g, uint32_t turn);
@@ -0,0 +1,195 @@
+#include "LudoSearch.h"
+#include <cstring>
+
+// =================== TRANSPOSITION TABLE ========
+template <class V>
+void BasicTranspositionTable<V>::Resize(size_t megabytes) {
+    this->megabytes = megabytes;
+    size_t want = (megabytes << 20) / sizeof(BasicTTEntry<V>);
+    size_t n = 1;
+    while (n * 2 <= want) n *= 2;
+    slots.assign(n, BasicTTEntry<V>{});
+    mask = n - 1;
+}
+
+template <class V>
+void BasicTranspositionTable<V>::Clear() {
+    std::fill(slots.begin(), slots.end(), BasicTTEntry<V>{});
+}
+
+template <class V>
+const BasicTTEntry<V>* BasicTranspositionTable<V>::Probe(uint64_t key, int depth) const {
+    const BasicTTEntry<V>& e = slots[key & mask];
+    return (e.key == key && e.depth >= depth) ? &e : nullptr;
+}
+
+template <class V>
+void BasicTranspositionTable<V>::Store(uint64_t key, int depth, const float v[V::PLAYERS]) {
+    BasicTTEntry<V>& e = slots[key & mask];
+    if (e.key != key && e.key != 0 && e.depth > depth) return;   // keep the deeper result
+    e.key = key;
+    e.depth = depth;
+    std::memcpy(e.v, v, sizeof(e.v));
+}
+
+// =================== EVALUATION =================
+// Each seat scores its lead over the average opponent.
+template <class V>
+static void LeadOverField(const float raw[V::PLAYERS], float out[V::PLAYERS]) {
+    float total = 0.0f;
+    for (int p = 0; p < V::PLAYERS; ++p) total += raw[p];
+    for (int p = 0; p < V::PLAYERS; ++p)
+        out[p] = raw[p] - (total - raw[p]) / (V::PLAYERS - 1);
+}
+
+template <class V>
+void EvaluateFeatures(const BasicGameState<V>& s, BasicEvalFeatures<V>& f, float out[V::PLAYERS]) {
+    RefreshExposure(s, f);
+    float raw[V::PLAYERS];
+    for (int p = 0; p < V::PLAYERS; ++p) {
+        if (IsFinished(s, p)) { raw[p] = 2.0f + (float)(V::PLAYERS - s.finishPlace[p]); continue; }
+        // Progress of all pieces, exposed pieces counting half.
+        const int full = NUM_PIECES * (V::HOME_STOP - V::START[p] + 1);
+        raw[p] = (full - f.distance[p] - 0.5f * f.exposedProgress[p]) * (1.0f / full);
+    }
+    LeadOverField<V>(raw, out);
+}
+
+template <class V>
+void EvaluateState(const BasicGameState<V>& s, float out[V::PLAYERS]) {
+    BasicEvalFeatures<V> f = ComputeFeatures(s);
+    EvaluateFeatures(s, f, out);
+}
+
+template <class V>
+void ValueFromPlaces(const float place[V::PLAYERS], float out[V::PLAYERS]) {
+    float raw[V::PLAYERS];
+    for (int p = 0; p < V::PLAYERS; ++p) raw[p] = 2.0f + (V::PLAYERS - place[p]);
+    LeadOverField<V>(raw, out);
+}
+
+// Only the classic board has a race tablebase.
+static bool ProbeTablebase(const RaceTablebase* tb, const GameState& s, float place[NUM_PLAYERS]) {
+    return tb && tb->Probe(s, place);
+}
+
+template <class V>
+static bool ProbeTablebase(const RaceTablebase*, const BasicGameState<V>&, float*) { return false; }
+
+// =================== SEARCH =====================
+template <class V>
+BasicExpectiSearch<V>::BasicExpectiSearch(size_t ttMegabytes) {
+    tt.Resize(ttMegabytes);
+}
+
+template <class V>
+bool BasicExpectiSearch<V>::TimeUp() {
+    if (aborted) return true;
+    if ((!timed && !cancel) || (++polls & 255) != 0) return false;
+    if (cancel && cancel->load(std::memory_order_relaxed)) aborted = true;
+    else if (timed && std::chrono::steady_clock::now() >= deadline) aborted = true;
+    return aborted;
+}
+
+// Both walk the member `node` with MakeMove/UnmakeMove and leave it as
+// they found it, aborted or not.
+template <class V>
+void BasicExpectiSearch<V>::Chance(int depth, float out[V::PLAYERS]) {
+    ++nodes;
+    if (IsGameOver(node)) { EvaluateFeatures(node, features, out); return; }
+    float place[V::PLAYERS];
+    if (ProbeTablebase(tablebase, node, place)) { ++tbHits; ValueFromPlaces<V>(place, out); return; }
+    if (depth <= 0) { EvaluateFeatures(node, features, out); return; }
+    uint64_t key = features.zobrist | 1;
+    if (const BasicTTEntry<V>* e = tt.Probe(key, depth)) {
+        ++ttHits;
+        std::memcpy(out, e->v, sizeof(e->v));
+        return;
+    }
+    float acc[V::PLAYERS] = {};
+    for (int d = 1; d <= 6; ++d) {
+        float v[V::PLAYERS];
+        Decide(d, depth, v);
+        if (aborted) return;
+        for (int p = 0; p < V::PLAYERS; ++p) acc[p] += v[p];
+    }
+    for (int p = 0; p < V::PLAYERS; ++p) out[p] = acc[p] / 6.0f;
+    tt.Store(key, depth, out);
+}
+
+template <class V>
+void BasicExpectiSearch<V>::Decide(int dice, int depth, float out[V::PLAYERS]) {
+    if (TimeUp()) return;
+    MoveList legal = LegalMoves(node, dice);
+    BasicUndoRecord<V> undo;
+    if (legal.empty()) {
+        MakeMove(node, features, { (int8_t)PASS, (uint8_t)dice }, undo);
+        Chance(depth - 1, out);
+        UnmakeMove(node, features, undo);
+        return;
+    }
+    int me = node.current;
+    float best = -1e30f;
+    for (const Move& mv : legal) {
+        float v[V::PLAYERS];
+        MakeMove(node, features, mv, undo);
+        Chance(depth - 1, v);
+        UnmakeMove(node, features, undo);
+        if (aborted) return;
+        if (v[me] > best) { best = v[me]; std::memcpy(out, v, sizeof(v)); }
+    }
+}
+
+template <class V>
+Move BasicExpectiSearch<V>::Pick(const State& s, const MoveList& legal, const SearchLimits& limits,
+                                 SearchStats* stats) {
+    auto t0 = std::chrono::steady_clock::now();
+    nodes = 0; ttHits = 0; tbHits = 0; polls = 0; aborted = false;
+    timed = limits.timeBudgetMs > 0;
+    cancel = limits.cancel;
+    deadline = t0 + std::chrono::milliseconds(limits.timeBudgetMs);
+
+    Move best = legal.m[0];
+    int completed = 0;
+    if (legal.count > 1) {
+        node = s;
+        features = ComputeFeatures(s);
+        int me = s.current;
+        for (int depth = 1; depth <= limits.maxDepth; ++depth) {
+            Move iterBest = legal.m[0];
+            float iterScore = -1e30f;
+            for (const Move& mv : legal) {
+                float v[V::PLAYERS];
+                BasicUndoRecord<V> undo;
+                MakeMove(node, features, mv, undo);
+                Chance(depth - 1, v);
+                UnmakeMove(node, features, undo);
+                if (aborted) break;
+                if (v[me] > iterScore) { iterScore = v[me]; iterBest = mv; }
+            }
+            if (aborted) break;
+            best = iterBest;
+            completed = depth;
+        }
+    }
+    if (stats) {
+        stats->depth = completed;
+        stats->nodes = nodes;
+        stats->ttHits = ttHits;
+        stats->tbHits = tbHits;
+        stats->ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+    return best;
+}
+
+// =================== VARIANTS ===================
+#define LUDO_INSTANTIATE_SEARCH(V)                                                  \
+    template struct BasicTranspositionTable<V>;                                     \
+    template class BasicExpectiSearch<V>;                                           \
+    template void EvaluateState<V>(const BasicGameState<V>&, float*);               \
+    template void EvaluateFeatures<V>(const BasicGameState<V>&, BasicEvalFeatures<V>&, float*); \
+    template void ValueFromPlaces<V>(const float*, float*);
+
+LUDO_INSTANTIATE_SEARCH(ClassicBoard)
+LUDO_INSTANTIATE_SEARCH(DuelBoard)
+LUDO_INSTANTIATE_SEARCH(SixBoard)
@@ -0,0 +1,102 @@
+#pragma once
+// Expectiminimax search player.
+//
+// The search walks a single state in place with MakeMove/UnmakeMove
+// (LudoEngine.h), reading the hash and evaluation features it keeps.
+// Decision nodes pick a move for the side to move (max-n: every seat
+// maximises its own share of a per-player value vector); chance nodes
+// average the six dice faces. Chance nodes are cached in a fixed-size,
+// Zobrist-keyed transposition table. Pick() deepens iteratively and
+// returns the best move of the last finished iteration once the time
+// budget runs out or the caller cancels.
+#include "LudoEngine.h"
+#include "LudoTablebase.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+struct SearchLimits {
+    int maxDepth = 32;            // chance layers below the root
+    int timeBudgetMs = 0;         // 0 = depth limit only (deterministic)
+    const std::atomic<bool>* cancel = nullptr;   // set from another thread: stop as if out of time
+};
+
+struct SearchStats {
+    int      depth = 0;           // deepest fully searched iteration
+    uint64_t nodes = 0;
+    uint64_t ttHits = 0;
+    uint64_t tbHits = 0;          // chance nodes answered by the race tablebase
+    double   ms = 0.0;
+};
+
+template <class V>
+struct BasicTTEntry {
+    uint64_t key;                 // 0 = empty slot
+    float    v[V::PLAYERS];
+    int32_t  depth;
+};
+
+// Fixed-memory transposition table, one entry per slot, depth-preferred
+// replacement. Size is rounded down to a power of two entries.
+template <class V>
+struct BasicTranspositionTable {
+    std::vector<BasicTTEntry<V>> slots;
+    uint64_t mask = 0;
+    size_t megabytes = 0;         // as requested; entry size varies by variant
+
+    void Resize(size_t megabytes);
+    void Clear();
+    const BasicTTEntry<V>* Probe(uint64_t key, int depth) const;
+    void Store(uint64_t key, int depth, const float v[V::PLAYERS]);
+};
+
+// Static evaluation: per-player progress towards home, with a penalty for
+// pieces an enemy can hit next turn and a bonus for finishing places.
+// EvaluateFeatures reads the incrementally kept features of MakeMove
+// (refreshing stale exposure counts); EvaluateState computes them first.
+template <class V>
+void EvaluateFeatures(const BasicGameState<V>& s, BasicEvalFeatures<V>& f, float out[V::PLAYERS]);
+template <class V>
+void EvaluateState(const BasicGameState<V>& s, float out[V::PLAYERS]);
+
+// The same scale from (expected) finishing places: what EvaluateState
+// returns once those places are decided.
+template <class V = ClassicBoard>
+void ValueFromPlaces(const float place[V::PLAYERS], float out[V::PLAYERS]);
+
+// One search per board variant (LudoBoard.h); the race tablebase only
+// covers the classic board and is ignored by the others.
+template <class V>
+class BasicExpectiSearch {
+public:
+    using State = BasicGameState<V>;
+
+    explicit BasicExpectiSearch(size_t ttMegabytes = 16);
+
+    Move Pick(const State& s, const MoveList& legal, const SearchLimits& limits,
+              SearchStats* stats = nullptr);
+    void ClearTable() { tt.Clear(); }
+    // Race positions covered by `tb` become exact leaves (nullptr: none).
+    void SetTablebase(const RaceTablebase* tb) { tablebase = tb; }
+    size_t TableMegabytes() const { return tt.megabytes; }
+
+private:
+    void Chance(int depth, float out[V::PLAYERS]);
+    void Decide(int dice, int depth, float out[V::PLAYERS]);
+    bool TimeUp();
+
+    State node;                           // position being searched
+    BasicEvalFeatures<V> features;        // kept in step with `node`
+    BasicTranspositionTable<V> tt;
+    const RaceTablebase* tablebase = nullptr;
+    std::chrono::steady_clock::time_point deadline;
+    const std::atomic<bool>* cancel = nullptr;
+    bool timed = false;
+    bool aborted = false;
+    uint64_t nodes = 0, ttHits = 0, tbHits = 0, polls = 0;
+};
+
+using TTEntry = BasicTTEntry<ClassicBoard>;
+using TranspositionTable = BasicTranspositionTable<ClassicBoard>;
+using ExpectiSearch = BasicExpectiSearch<ClassicBoard>;
@@ -0,0 +1,386 @@
+// ludo_server: authoritative multi-table game server (protocol in LudoNet.h).
+//
+//   ludo_server [--port P] [--threads T] [--seed S]
+//
+// Each thread runs its own epoll loop on its own SO_REUSEPORT listener and
+// owns every connection and table it accepts, so nothing is shared and no
+// lock sits on the move path. The server holds the dice (CounterRng per
+// table) and checks every move against the engine before applying it.
+// Linux only.
+#include "LudoAi.h"
+#include "LudoNet.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static const int MAX_EVENTS = 256;
+static const int NO_CONN = -1;                  // Table::conn for seats the server plays
+
+static std::atomic<bool> stopping{ false };
+
+struct Conn {
+    int fd = -1;
+    std::vector<uint8_t> in, out;
+    size_t outSent = 0;
+    int table = -1;
+    uint8_t seatMask = 0;
+    bool dirty = false;                         // queued in Reactor::dirty
+    bool writeArmed = false;                    // EPOLLOUT registered
+};
+
+struct Table {
+    GameState s;
+    CounterRng dice, ai;
+    int conn[NUM_PLAYERS];
+    uint8_t taken = 0;                          // seats handed out
+    bool live = false;
+    uint32_t turn = 0;
+    uint8_t rolled = 0, legalMask = 0;          // the TURN clients are answering
+};
+
+struct alignas(64) ReactorStats {
+    std::atomic<uint64_t> moves{ 0 }, rejects{ 0 }, gamesDone{ 0 }, conns{ 0 }, liveTables{ 0 };
+};
+
+struct Reactor {
+    int id = 0, ep = -1, listenFd = -1;
+    uint64_t seed = 0, serial = 0;
+    std::vector<std::unique_ptr<Conn>> byFd;
+    std::vector<Table> tables;
+    std::vector<int> freeTables, openTables;
+    std::vector<int> dirty;
+    ReactorStats stats;
+
+    Conn* ConnOf(int fd) { return (fd >= 0 && (size_t)fd < byFd.size()) ? byFd[fd].get() : nullptr; }
+
+    // =================== OUTPUT =====================
+    template <class T>
+    void Send(int fd, NetMsg type, const T& body) {
+        Conn* c = ConnOf(fd);
+        if (!c) return;
+        NetAppend(c->out, type, body);
+        if (!c->dirty) { c->dirty = true; dirty.push_back(fd); }
+    }
+
+    void Reject(Conn& c, NetReject why) {
+        stats.rejects++;
+        Send(c.fd, MSG_REJECT, MsgReject{ (uint32_t)c.table, (uint8_t)why });
+    }
+
+    // Writes as much as the socket takes; the rest waits for EPOLLOUT.
+    bool Flush(Conn& c) {
+        while (c.outSent < c.out.size()) {
+            ssize_t n = ::send(c.fd, c.out.data() + c.outSent, c.out.size() - c.outSent, MSG_NOSIGNAL);
+            if (n > 0) { c.outSent += (size_t)n; continue; }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            return false;
+        }
+        if (c.outSent == c.out.size()) { c.out.clear(); c.outSent = 0; }
+        bool wantWrite = !c.out.empty();
+        if (wantWrite != c.writeArmed) {
+            epoll_event ev{};
+            ev.events = wantWrite ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+            ev.data.fd = c.fd;
+            epoll_ctl(ep, EPOLL_CTL_MOD, c.fd, &ev);
+            c.writeArmed = wantWrite;
+        }
+        return true;
+    }
+
+    // =================== TABLES =====================
+    int NewTable() {
+        int t;
+        if (!freeTables.empty()) { t = freeTables.back(); freeTables.pop_back(); }
+        else { t = (int)tables.size(); tables.emplace_back(); }
+        Table& tb = tables[t];
+        uint64_t index = ((uint64_t)id << 40) | serial++;
+        tb.s = NewGame();
+        tb.dice = CounterRng(seed, index, STREAM_DICE);
+        tb.ai = CounterRng(seed, index, STREAM_AI);
+        for (int& c : tb.conn) c = NO_CONN;
+        tb.taken = 0; tb.live = false; tb.turn = 0; tb.rolled = 0; tb.legalMask = 0;
+        openTables.push_back(t);
+        return t;
+    }
+
+    void ReleaseTable(int t) {
+        Table& tb = tables[t];
+        for (int p = 0; p < NUM_PLAYERS; ++p)
+            if (Conn* c = ConnOf(tb.conn[p])) { c->table = -1; c->seatMask = 0; }
+        if (tb.live) stats.liveTables--;
+        tb.live = false;
+        for (size_t i = 0; i < openTables.size(); ++i)
+            if (openTables[i] == t) { openTables.erase(openTables.begin() + i); break; }
+        freeTables.push_back(t);
+    }
+
+    template <class T>
+    void Broadcast(const Table& tb, NetMsg type, const T& body) {
+        for (int p = 0; p < NUM_PLAYERS; ++p) {
+            int fd = tb.conn[p];
+            bool seen = false;
+            for (int q = 0; q < p; ++q) seen = seen || tb.conn[q] == fd;
+            if (fd != NO_CONN && !seen) Send(fd, type, body);
+        }
+    }
+
+    // Rolls and plays until a connected seat has a real choice or the game
+    // ends. Passes and abandoned seats never wait on the network.
+    void Advance(int t) {
+        Table& tb = tables[t];
+        while (!IsGameOver(tb.s) && tb.turn < MAX_PLIES) {
+            int seat = tb.s.current;
+            int dice = tb.dice.RollDice();
+            MoveList legal = LegalMoves(tb.s, dice);
+            if (legal.empty()) {
+                tb.s = ApplyMove(tb.s, { (int8_t)PASS, (uint8_t)dice });
+                tb.turn++;
+                continue;
+            }
+            if (tb.conn[seat] == NO_CONN) {
+                tb.s = ApplyMove(tb.s, PickGreedyMove(tb.s, legal, AiWeights(), tb.ai));
+                tb.turn++;
+                continue;
+            }
+            tb.rolled = (uint8_t)dice;
+            tb.legalMask = LegalMask(legal);
+            MsgTurn m;
+            m.table = (uint32_t)t; m.turn = tb.turn; m.seat = (uint8_t)seat;
+            m.dice = tb.rolled; m.legalMask = tb.legalMask;
+            PackState(tb.s, m.state);
+            Broadcast(tb, MSG_TURN, m);
+            return;
+        }
+        MsgGameOver m;
+        m.table = (uint32_t)t; m.turns = tb.turn;
+        std::memcpy(m.finishPlace, tb.s.finishPlace, NUM_PLAYERS);
+        Broadcast(tb, MSG_GAME_OVER, m);
+        stats.gamesDone++;
+        ReleaseTable(t);
+    }
+
+    // =================== MESSAGES ===================
+    void OnJoin(Conn& c, const MsgJoin& j) {
+        if (j.version != NET_VERSION) { Reject(c, REJECT_VERSION); return; }
+        if (c.table >= 0) { Reject(c, REJECT_ALREADY_SEATED); return; }
+        if (j.seats < 1 || j.seats > NUM_PLAYERS) { Reject(c, REJECT_BAD_MESSAGE); return; }
+        int t = -1;
+        for (int o : openTables)
+            if (NUM_PLAYERS - __builtin_popcount(tables[o].taken) >= j.seats) { t = o; break; }
+        if (t < 0) t = NewTable();
+        Table& tb = tables[t];
+        uint8_t mask = 0;
+        for (int p = 0, n = 0; p < NUM_PLAYERS && n < j.seats; ++p)
+            if (!(tb.taken & (1 << p))) { mask |= (uint8_t)(1 << p); tb.conn[p] = c.fd; ++n; }
+        tb.taken |= mask;
+        c.table = t; c.seatMask = mask;
+        Send(c.fd, MSG_WELCOME, MsgWelcome{ (uint32_t)t, mask });
+        if (tb.taken == (1 << NUM_PLAYERS) - 1) {
+            for (size_t i = 0; i < openTables.size(); ++i)
+                if (openTables[i] == t) { openTables.erase(openTables.begin() + i); break; }
+            tb.live = true;
+            stats.liveTables++;
+            Advance(t);
+        }
+    }
+
+    void OnMove(Conn& c, const MsgMove& m) {
+        if (c.table < 0 || !tables[c.table].live) { Reject(c, REJECT_NOT_SEATED); return; }
+        Table& tb = tables[c.table];
+        if (!(c.seatMask & (1 << tb.s.current))) { Reject(c, REJECT_NOT_YOUR_TURN); return; }
+        if (m.turn != tb.turn) { Reject(c, REJECT_STALE_TURN); return; }
+        if (m.piece >= NUM_PIECES || !(tb.legalMask & (1 << m.piece))) { Reject(c, REJECT_ILLEGAL_MOVE); return; }
+        tb.s = ApplyMove(tb.s, { (int8_t)m.piece, tb.rolled });
+        tb.turn++;
+        stats.moves++;
+        Advance(c.table);
+    }
+
+    // Returns false if the connection must be dropped.
+    bool OnReadable(Conn& c) {
+        uint8_t buf[4096];
+        for (;;) {
+            ssize_t n = ::recv(c.fd, buf, sizeof(buf), 0);
+            if (n > 0) { c.in.insert(c.in.end(), buf, buf + n); continue; }
+            if (n == 0) return false;
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return false;
+        }
+        size_t at = 0;
+        long len;
+        while ((len = NetFrameLength(c.in.data() + at, c.in.size() - at)) > 0) {
+            const uint8_t* frame = c.in.data() + at;
+            at += (size_t)len;
+            MsgJoin j;
+            MsgMove m;
+            switch (frame[sizeof(uint16_t)]) {
+            case MSG_JOIN: if (NetBody(frame, len, j)) OnJoin(c, j); else Reject(c, REJECT_BAD_MESSAGE); break;
+            case MSG_MOVE: if (NetBody(frame, len, m)) OnMove(c, m); else Reject(c, REJECT_BAD_MESSAGE); break;
+            default: Reject(c, REJECT_BAD_MESSAGE); break;
+            }
+        }
+        c.in.erase(c.in.begin(), c.in.begin() + at);
+        return len >= 0;
+    }
+
+    // =================== CONNECTIONS ================
+    void Accept() {
+        for (;;) {
+            int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return;
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            if ((size_t)fd >= byFd.size()) byFd.resize(fd + 1);
+            byFd[fd].reset(new Conn());
+            byFd[fd]->fd = fd;
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.fd = fd;
+            epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev);
+            stats.conns++;
+        }
+    }
+
+    // The departed client's seats are taken over by the server's greedy
+    // bot; a table with nobody left is dropped.
+    void Drop(int fd) {
+        Conn* c = ConnOf(fd);
+        if (!c) return;
+        int t = c->table;
+        epoll_ctl(ep, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        byFd[fd].reset();
+        stats.conns--;
+        if (t < 0) return;
+        Table& tb = tables[t];
+        bool anyone = false;
+        for (int p = 0; p < NUM_PLAYERS; ++p) {
+            if (tb.conn[p] == fd) {
+                tb.conn[p] = NO_CONN;
+                if (!tb.live) tb.taken &= (uint8_t)~(1 << p);
+            }
+            anyone = anyone || tb.conn[p] != NO_CONN;
+        }
+        if (!anyone) ReleaseTable(t);
+        else if (tb.live && tb.conn[tb.s.current] == NO_CONN) {
+            // The TURN that was pending belonged to the leaver: finish it for them.
+            MoveList legal = LegalMoves(tb.s, tb.rolled);
+            tb.s = ApplyMove(tb.s, PickGreedyMove(tb.s, legal, AiWeights(), tb.ai));
+            tb.turn++;
+            Advance(t);
+        }
+    }
+
+    void Run() {
+        epoll_event events[MAX_EVENTS];
+        while (!stopping.load(std::memory_order_relaxed)) {
+            int n = epoll_wait(ep, events, MAX_EVENTS, 100);
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == listenFd) { Accept(); continue; }
+                Conn* c = ConnOf(fd);
+                if (!c) continue;
+                bool ok = !(events[i].events & (EPOLLERR | EPOLLHUP));
+                if (ok && (events[i].events & EPOLLIN)) ok = OnReadable(*c);
+                if (ok && (events[i].events & EPOLLOUT)) ok = Flush(*c);
+                if (!ok) Drop(fd);
+            }
+            // One send per connection per wakeup, however many frames queued.
+            for (size_t i = 0; i < dirty.size(); ++i) {
+                Conn* c = ConnOf(dirty[i]);
+                if (!c) continue;
+                c->dirty = false;
+                if (!Flush(*c)) Drop(c->fd);
+            }
+            dirty.clear();
+        }
+    }
+};
+
+static int Listen(int port) {
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons((uint16_t)port);
+    if (::bind(fd, (sockaddr*)&addr, sizeof(addr)) != 0 || ::listen(fd, 4096) != 0) { ::close(fd); return -1; }
+    return fd;
+}
+
+static void OnSignal(int) { stopping = true; }
+
+int main(int argc, char** argv) {
+    int port = NET_DEFAULT_PORT, threads = 1;
+    uint64_t seed = (uint64_t)time(nullptr);
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--port")) port = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--threads")) threads = std::max(1, atoi(argv[i + 1]));
+        else if (!strcmp(argv[i], "--seed")) seed = strtoull(argv[i + 1], nullptr, 10);
+        else { fprintf(stderr, "usage: %s [--port P] [--threads T] [--seed S]\n", argv[0]); return 2; }
+    }
+    signal(SIGINT, OnSignal);
+    signal(SIGTERM, OnSignal);
+
+    std::vector<std::unique_ptr<Reactor>> reactors;
+    for (int t = 0; t < threads; ++t) {
+        std::unique_ptr<Reactor> r(new Reactor());
+        r->id = t; r->seed = seed;
+        r->listenFd = Listen(port);
+        r->ep = epoll_create1(EPOLL_CLOEXEC);
+        if (r->listenFd < 0 || r->ep < 0) { fprintf(stderr, "cannot listen on port %d\n", port); return 1; }
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = r->listenFd;
+        epoll_ctl(r->ep, EPOLL_CTL_ADD, r->listenFd, &ev);
+        reactors.push_back(std::move(r));
+    }
+    printf("ludo_server on port %d, %d thread(s), seed %llu\n", port, threads, (unsigned long long)seed);
+    fflush(stdout);
+
+    std::vector<std::thread> pool;
+    for (auto& r : reactors) pool.emplace_back([&r] { r->Run(); });
+
+    uint64_t lastMoves = 0;
+    auto last = std::chrono::steady_clock::now();
+    while (!stopping) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        auto now = std::chrono::steady_clock::now();
+        double secs = std::chrono::duration<double>(now - last).count();
+        if (secs < 5.0) continue;
+        uint64_t moves = 0, rejects = 0, games = 0, conns = 0, live = 0;
+        for (auto& r : reactors) {
+            moves += r->stats.moves; rejects += r->stats.rejects; games += r->stats.gamesDone;
+            conns += r->stats.conns; live += r->stats.liveTables;
+        }
+        printf("%llu conns, %llu live tables, %.0f moves/s, %llu games done, %llu rejects\n",
+            (unsigned long long)conns, (unsigned long long)live, (moves - lastMoves) / secs,
+            (unsigned long long)games, (unsigned long long)rejects);
+        fflush(stdout);
+        lastMoves = moves;
+        last = now;
+    }
+    for (auto& th : pool) th.join();
+    for (auto& r : reactors) { ::close(r->listenFd); ::close(r->ep); }
+    return 0;
+}
@@ -0,0 +1,249 @@
+// ludo_sim: headless Monte-Carlo tournament between AI policies.
+//
+//   ludo_sim [--games N] [--threads T] [--seed S] [--seats a,b,c,d] [--players 2|4|6]
+//            [--replay FILE] [--tablebase FILE]
+//   ludo_sim --selfcheck      verify the move tables, make/unmake and cut-short replays, then exit
+//   ludo_sim --alloc-check    (built with -DLUDO_COUNT_ALLOCS) fail if a game allocates
+//
+// Seats are listed YELLOW,BLUE,GREEN,RED and take random|first|greedy|search[:depth[:ms]].
+// --players picks the board variant (LudoBoard.h): 4 is the classic game,
+// 2 the YELLOW,RED duel and 6 the long six-seat board. Replays and the
+// tablebase exist for the classic board only.
+// Game i always uses dice stream (seed, i), so the totals are identical
+// for any thread count. --replay logs every game (LudoReplay.h); games
+// land in the file in completion order, each tagged with its index.
+// --tablebase maps a ludo_tbgen file and lets greedy and search seats play
+// covered race endings exactly.
+#include "LudoAi.h"
+#include "AllocCounter.h"
+#include "LudoReplay.h"
+#include "TaskScheduler.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+static const char* SeatName(int players, int p) {
+    static const char* const CLASSIC[] = { "Yellow", "Blue", "Green", "Red" };
+    static const char* const DUEL[] = { "Yellow", "Red" };
+    static const char* const SIX[] = { "Seat0", "Seat1", "Seat2", "Seat3", "Seat4", "Seat5" };
+    return players == 2 ? DUEL[p] : players == 4 ? CLASSIC[p] : SIX[p];
+}
+
+struct alignas(64) SimTally {
+    uint64_t games = 0;
+    uint64_t plies = 0;
+    uint64_t unfinished = 0;
+    uint64_t places[MAX_SEATS][MAX_SEATS + 1] = {};   // [seat][place]
+};
+
+// 95% Wilson score interval for k successes out of n.
+static void Wilson(uint64_t k, uint64_t n, double& lo, double& hi) {
+    if (n == 0) { lo = hi = 0; return; }
+    const double z = 1.96;
+    double p = (double)k / n, z2n = z * z / n;
+    double centre = (p + z2n / 2) / (1 + z2n);
+    double half = z * sqrt(p * (1 - p) / n + z2n / (4.0 * n)) / (1 + z2n);
+    lo = centre - half; hi = centre + half;
+}
+
+static bool ParseSeats(const char* list, Policy seats[MAX_SEATS]) {
+    std::string s(list);
+    size_t pos = 0;
+    for (int p = 0; p < MAX_SEATS; ++p) {
+        size_t comma = s.find(',', pos);
+        std::string name = s.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+        if (!ParsePolicy(name.c_str(), seats[p])) return false;
+        if (comma == std::string::npos) {
+            for (int q = p + 1; q < MAX_SEATS; ++q) seats[q] = seats[p];   // repeat the last one
+            return true;
+        }
+        pos = comma + 1;
+    }
+    return true;
+}
+
+// Steady-state games must not touch the heap: one warm-up game sizes the
+// per-thread search table, after which the count has to stay at zero.
+static int AllocCheck(const Policy seats[NUM_PLAYERS]) {
+    if (!AllocCountingEnabled()) {
+        fprintf(stderr, "--alloc-check needs a build with -DLUDO_COUNT_ALLOCS\n");
+        return 2;
+    }
+    Policy mixed[NUM_PLAYERS] = { seats[0], seats[1], seats[2], seats[3] };
+    mixed[0].kind = POLICY_SEARCH;
+    PlayGame(mixed, 1, 0);
+    AllocScope scope;
+    for (uint64_t g = 1; g <= 200; ++g) PlayGame(mixed, 1, g);
+    printf("allocations in 200 games: %llu\n", (unsigned long long)scope.Count());
+    return scope.Count() ? 1 : 0;
+}
+
+// A game cut short (no EndGame, as after a crash or a quit mid-game) must
+// read back to its last recorded turn. Greedy games are logged without
+// EndGame up to several cut points around the keyframes; every turn is
+// then sought and compared. Returns the number of mismatches.
+static int VerifyReplayCutShort() {
+    static const uint32_t CUTS[] = { 1, 31, 32, 33, 64, 70 };
+    int bad = 0;
+    for (uint32_t cut : CUTS) {
+        ReplayEncoder enc;
+        enc.BeginGame(1, cut);
+        CounterRng dice(1, cut, STREAM_DICE), ai(1, cut, STREAM_AI);
+        const AiWeights greedy;
+        std::vector<GameState> after(1, NewGame());
+        while (enc.turns < cut && !IsGameOver(after.back())) {
+            const GameState s = after.back();      // a copy: push_back may reallocate
+            int d = dice.RollDice();
+            MoveList legal = LegalMoves(s, d);
+            Move mv = legal.empty() ? Move{ (int8_t)PASS, (uint8_t)d } : PickGreedyMove(s, legal, greedy, ai);
+            after.push_back(ApplyMove(s, mv));
+            enc.Record(s.current, mv, after.back());
+        }
+        std::vector<uint8_t> file;
+        WriteReplayFileHeader(file);
+        file.insert(file.end(), enc.bytes.begin(), enc.bytes.end());
+
+        int interval = 0;
+        ReplayGameView g;
+        if (!CheckReplayFileHeader(file.data(), file.size(), interval)
+            || !NextReplayGame(file.data(), file.size(), sizeof(ReplayFileHeader), interval, g)
+            || g.turns != enc.turns) { ++bad; continue; }
+        for (uint32_t t = 0; t <= g.turns; ++t) {
+            GameState s;
+            const GameState& want = after[t];
+            if (!SeekReplay(g, t, s) || s.current != want.current || s.nextPlace != want.nextPlace
+                || memcmp(s.sq, want.sq, sizeof(s.sq)) || memcmp(s.finishPlace, want.finishPlace, sizeof(s.finishPlace)))
+                ++bad;
+        }
+    }
+    return bad;
+}
+
+static int SelfCheck() {
+    int bad[3] = { VerifyStepTables<ClassicBoard>(), VerifyStepTables<DuelBoard>(), VerifyStepTables<SixBoard>() };
+    int undo[3] = { VerifyMakeUnmake<ClassicBoard>(200), VerifyMakeUnmake<DuelBoard>(200), VerifyMakeUnmake<SixBoard>(200) };
+    int cutShort = VerifyReplayCutShort();
+    printf("step tables: %d mismatches (4 players), %d (2 players), %d (6 players)\n", bad[0], bad[1], bad[2]);
+    printf("make/unmake: %d mismatches (4 players), %d (2 players), %d (6 players)\n", undo[0], undo[1], undo[2]);
+    printf("replay cut short: %d mismatches\n", cutShort);
+    return bad[0] || bad[1] || bad[2] || undo[0] || undo[1] || undo[2] || cutShort ? 1 : 0;
+}
+
+// Plays `games` games on variant V and prints the per-seat table.
+template <class V>
+static int RunTournament(const Policy seats[MAX_SEATS], uint64_t games, uint64_t seed, int threads,
+                         const char* replayPath) {
+    FILE* replay = nullptr;
+    std::mutex replayLock;
+    if (replayPath) {
+        replay = fopen(replayPath, "wb");
+        if (!replay) { fprintf(stderr, "cannot write %s\n", replayPath); return 1; }
+        std::vector<uint8_t> hdr;
+        WriteReplayFileHeader(hdr);
+        fwrite(hdr.data(), 1, hdr.size(), replay);
+    }
+    std::vector<ReplayEncoder> encoders(threads);
+    auto flushReplay = [&](ReplayEncoder& enc) {
+        std::lock_guard<std::mutex> lk(replayLock);
+        fwrite(enc.bytes.data(), 1, enc.bytes.size(), replay);
+        enc.bytes.clear();
+    };
+
+    std::vector<SimTally> tallies(threads);
+    auto t0 = std::chrono::steady_clock::now();
+    ParallelFor(games, threads, 256, [&](int w, uint64_t b, uint64_t e) {
+        SimTally& t = tallies[w];
+        ReplayEncoder* rec = replay ? &encoders[w] : nullptr;
+        for (uint64_t g = b; g < e; ++g) {
+            GameResult r = PlayGame<V>(seats, seed, g, rec);
+            if (rec && rec->bytes.size() >= (1u << 20)) flushReplay(*rec);
+            t.games++;
+            t.plies += r.plies;
+            if (r.plies >= MAX_PLIES) t.unfinished++;
+            for (int p = 0; p < V::PLAYERS; ++p) t.places[p][r.finishPlace[p]]++;
+        }
+    });
+    if (replay) {
+        for (ReplayEncoder& enc : encoders) flushReplay(enc);
+        fclose(replay);
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    SimTally total;
+    for (const SimTally& t : tallies) {
+        total.games += t.games; total.plies += t.plies; total.unfinished += t.unfinished;
+        for (int p = 0; p < V::PLAYERS; ++p)
+            for (int k = 0; k <= V::PLAYERS; ++k) total.places[p][k] += t.places[p][k];
+    }
+
+    printf("games      %llu (seed %llu, %d threads, %d players)\n", (unsigned long long)total.games,
+        (unsigned long long)seed, threads, V::PLAYERS);
+    printf("time       %.3f s, %.0f games/s, %.1f plies/game\n", secs,
+        secs > 0 ? total.games / secs : 0.0, total.games ? (double)total.plies / total.games : 0.0);
+    if (total.unfinished) printf("unfinished %llu (hit MAX_PLIES)\n", (unsigned long long)total.unfinished);
+    printf("\n%-7s %-7s %8s  %-17s %9s\n", "seat", "policy", "win%", "95% CI", "avg place");
+    for (int p = 0; p < V::PLAYERS; ++p) {
+        uint64_t wins = total.places[p][1];
+        double lo, hi, placeSum = 0;
+        Wilson(wins, total.games, lo, hi);
+        for (int k = 1; k <= V::PLAYERS; ++k) placeSum += (double)k * total.places[p][k];
+        printf("%-7s %-7s %7.2f%%  [%6.2f%%, %6.2f%%] %9.3f\n", SeatName(V::PLAYERS, p), PolicyName(seats[p].kind),
+            total.games ? 100.0 * wins / total.games : 0.0, 100 * lo, 100 * hi,
+            total.games ? placeSum / total.games : 0.0);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    uint64_t games = 100000, seed = 1;
+    int threads = DefaultThreadCount(), players = 4;
+    Policy seats[MAX_SEATS];
+    const char* replayPath = nullptr;
+    const char* tablebasePath = nullptr;
+    bool selfCheck = false, allocCheck = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!strcmp(a, "--games") && v) { games = strtoull(v, nullptr, 10); ++i; }
+        else if (!strcmp(a, "--threads") && v) { threads = atoi(v); ++i; }
+        else if (!strcmp(a, "--seed") && v) { seed = strtoull(v, nullptr, 10); ++i; }
+        else if (!strcmp(a, "--players") && v) { players = atoi(v); ++i; }
+        else if (!strcmp(a, "--replay") && v) { replayPath = v; ++i; }
+        else if (!strcmp(a, "--tablebase") && v) { tablebasePath = v; ++i; }
+        else if (!strcmp(a, "--selfcheck")) selfCheck = true;
+        else if (!strcmp(a, "--alloc-check")) allocCheck = true;
+        else if (!strcmp(a, "--seats") && v) {
+            if (!ParseSeats(v, seats)) { fprintf(stderr, "bad --seats list: %s\n", v); return 2; }
+            ++i;
+        }
+        else {
+            fprintf(stderr, "usage: %s [--games N] [--threads T] [--seed S] [--seats a,b,c,d] [--players 2|4|6] "
+                "[--replay FILE] [--tablebase FILE] [--selfcheck] [--alloc-check]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (threads < 1) threads = 1;
+    if (players != 2 && players != 4 && players != 6) { fprintf(stderr, "--players takes 2, 4 or 6\n"); return 2; }
+    if (players != 4 && (replayPath || tablebasePath)) {
+        fprintf(stderr, "--replay and --tablebase need the 4-player board\n");
+        return 2;
+    }
+
+    RaceTablebase tablebase;
+    if (tablebasePath) {
+        if (!tablebase.Open(tablebasePath)) { fprintf(stderr, "cannot map tablebase %s\n", tablebasePath); return 1; }
+        for (Policy& seat : seats) seat.tablebase = &tablebase;
+    }
+
+    if (selfCheck) return SelfCheck();
+    if (allocCheck) return AllocCheck(seats);
+    if (players == 2) return RunTournament<DuelBoard>(seats, games, seed, threads, nullptr);
+    if (players == 6) return RunTournament<SixBoard>(seats, games, seed, threads, nullptr);
+    return RunTournament<ClassicBoard>(seats, games, seed, threads, replayPath);
+}
@@ -0,0 +1,71 @@
+#include "LudoSnapshot.h"
+#include <cstring>
+
+static const char SNAPSHOT_MAGIC[8] = { 'L', 'U', 'D', 'O', 'S', 'N', 'A', 'P' };
+
+template <class V>
+static SnapshotFileHeader MakeHeader(uint64_t seed, uint64_t gameIndex) {
+    SnapshotFileHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic));
+    h.version = SNAPSHOT_VERSION;
+    h.players = V::PLAYERS;
+    h.snapshotBytes = sizeof(BasicSnapshot<V>);
+    h.seed = seed;
+    h.gameIndex = gameIndex;
+    return h;
+}
+
+template <class V>
+bool BasicSnapshotFile<V>::Open(const char* path) {
+    f = std::fopen(path, "wb");
+    return f != nullptr;
+}
+
+template <class V>
+bool BasicSnapshotFile<V>::Write(uint64_t seed, uint64_t gameIndex, const BasicSnapshot<V>& s) {
+    if (!f) return false;
+    SnapshotFileHeader h = MakeHeader<V>(seed, gameIndex);
+    std::fseek(f, 0, SEEK_SET);
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1 && std::fwrite(&s, sizeof(s), 1, f) == 1;
+    return std::fflush(f) == 0 && ok;
+}
+
+template <class V>
+void BasicSnapshotFile<V>::Close() {
+    if (f) std::fclose(f);
+    f = nullptr;
+}
+
+template <class V>
+bool LoadSnapshotFile(const char* path, uint64_t& seed, uint64_t& gameIndex, BasicSnapshot<V>& out) {
+    FILE* f = std::fopen(path, "rb");
+    if (!f) return false;
+    SnapshotFileHeader h, want = MakeHeader<V>(0, 0);
+    bool ok = std::fread(&h, sizeof(h), 1, f) == 1 && std::fread(&out, sizeof(out), 1, f) == 1;
+    std::fclose(f);
+    ok = ok && std::memcmp(h.magic, want.magic, sizeof(h.magic)) == 0 && h.version == want.version
+            && h.players == want.players && h.snapshotBytes == want.snapshotBytes;
+    if (!ok) return false;
+    // Squares in range and occupancy mirrors that agree with them, or the rules go wrong.
+    const BasicGameState<V>& g = out.game;
+    if (g.current >= V::PLAYERS || g.nextPlace < 1 || g.nextPlace > V::PLAYERS + 1) return false;
+    for (int p = 0; p < V::PLAYERS; ++p)
+        for (int i = 0; i < NUM_PIECES; ++i)
+            if (g.sq[p][i] < IN_BASE || g.sq[p][i] > V::HOME_STOP) return false;
+    BasicGameState<V> check = g;
+    RebuildOccupancy(check);
+    if (std::memcmp(&check, &g, sizeof(check)) != 0) return false;
+    seed = h.seed;
+    gameIndex = h.gameIndex;
+    return true;
+}
+
+// =================== VARIANTS ===================
+#define LUDO_INSTANTIATE_SNAPSHOT(V)                                                        \
+    template struct BasicSnapshotFile<V>;                                                   \
+    template bool LoadSnapshotFile<V>(const char*, uint64_t&, uint64_t&, BasicSnapshot<V>&);
+
+LUDO_INSTANTIATE_SNAPSHOT(ClassicBoard)
+LUDO_INSTANTIATE_SNAPSHOT(DuelBoard)
+LUDO_INSTANTIATE_SNAPSHOT(SixBoard)
@@ -0,0 +1,90 @@
+#pragma once
+// Game snapshots and a bounded undo/redo history.
+//
+// A Snapshot is everything needed to carry on a game from the moment it
+// was taken: the engine state (pieces, side to move, finish places), both
+// random streams, the dice shown and the replay position. It is plain
+// trivially-copyable bytes, so taking or restoring one is a copy of about
+// a hundred bytes. Presentation (colours, animations) is not stored; the
+// front end rebuilds it from the state.
+//
+// SnapshotFile keeps one snapshot on disk for crash recovery, rewritten
+// in place; a header records the board variant, seed and game index.
+#include "LudoEngine.h"
+#include "LudoRandom.h"
+#include <cstdio>
+#include <type_traits>
+#include <utility>
+
+static const int SNAPSHOT_VERSION = 1;
+
+template <class V>
+struct BasicSnapshot {
+    BasicGameState<V> game;
+    CounterRng dice;                    // next roll of the game
+    CounterRng ai;                      // AI tie-breaks
+    uint32_t turns;                     // turns played, i.e. the replay log position
+    uint8_t  rollResult;                // 0 = not rolled yet
+    uint8_t  hasRolled;
+    uint8_t  pad[2];
+};
+
+static_assert(std::is_trivially_copyable<BasicSnapshot<ClassicBoard>>::value, "snapshots are raw bytes");
+
+#pragma pack(push, 1)
+struct SnapshotFileHeader {
+    char     magic[8];                  // "LUDOSNAP"
+    uint16_t version;
+    uint16_t players;                   // board variant
+    uint32_t snapshotBytes;             // sizeof(BasicSnapshot<V>) of the writer
+    uint64_t seed;
+    uint64_t gameIndex;
+};
+#pragma pack(pop)
+
+// =================== HISTORY ====================
+// The last N snapshots with a cursor on the current one. Push() drops
+// everything after the cursor (the undone turns) and, when full, the
+// oldest entry. Undo()/Redo() move the cursor and return the snapshot to
+// restore, or nullptr at either end. Fixed storage, no allocation.
+template <class T, int N>
+class HistoryRing {
+public:
+    void Clear() { first = 0; count = 0; cursor = -1; }
+
+    void Push(T&& entry) {
+        count = cursor + 1;
+        if (count == N) { first = (first + 1) % N; --count; }
+        slots[(first + count) % N] = std::move(entry);
+        cursor = count++;
+    }
+
+    const T* Undo() { return cursor > 0 ? &slots[(first + --cursor) % N] : nullptr; }
+    const T* Redo() { return cursor + 1 < count ? &slots[(first + ++cursor) % N] : nullptr; }
+    int UndoDepth() const { return cursor > 0 ? cursor : 0; }
+    int RedoDepth() const { return count - cursor - 1; }
+
+private:
+    T slots[N];
+    int first = 0;                      // oldest entry
+    int count = 0;
+    int cursor = -1;                    // offset of the current entry from `first`
+};
+
+// =================== FILE =======================
+template <class V>
+struct BasicSnapshotFile {
+    FILE* f = nullptr;
+
+    bool Open(const char* path);        // creates or truncates
+    bool Write(uint64_t seed, uint64_t gameIndex, const BasicSnapshot<V>& s);   // overwrites, flushed
+    void Close();
+};
+
+// Reads a snapshot written for variant V; false if the file is missing,
+// damaged or from another variant or version.
+template <class V>
+bool LoadSnapshotFile(const char* path, uint64_t& seed, uint64_t& gameIndex, BasicSnapshot<V>& out);
+
+using Snapshot = BasicSnapshot<ClassicBoard>;
+using SnapshotFile = BasicSnapshotFile<ClassicBoard>;
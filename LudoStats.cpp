@@ -0,0 +1,185 @@
+// ludo_stats: aggregate statistics over replay logs (LudoReplay.h).
+//
+//   ludo_stats [--threads T] [--format json|csv] FILE...
+//
+// Files are memory-mapped; one quick hop over the game headers finds the
+// games, then workers replay each payload straight from the mapping with a
+// GameState on the stack. Nothing is deserialized into per-game objects.
+#include "LudoReplay.h"
+#include "MappedFile.h"
+#include "TaskScheduler.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+static const char* SEAT_NAMES[NUM_PLAYERS] = { "Yellow", "Blue", "Green", "Red" };
+static const int LENGTH_BUCKET = 25;            // turns per histogram bucket
+static const int LENGTH_BUCKETS = 80;           // last bucket collects the tail
+
+struct alignas(64) StatTally {
+    uint64_t games = 0, turns = 0, passes = 0, unfinished = 0, bad = 0;
+    uint64_t sixes = 0, spawns = 0, captured = 0;
+    uint64_t lengthHist[LENGTH_BUCKETS] = {};
+    uint64_t capturesAt[LOOP_LEN] = {};         // pieces sent home, by outerPath index
+    uint64_t landingsAt[LOOP_LEN] = {};         // moves ending on each loop square
+    uint64_t places[NUM_PLAYERS][NUM_PLAYERS + 1] = {};
+
+    void Add(const StatTally& o) {
+        games += o.games; turns += o.turns; passes += o.passes; unfinished += o.unfinished; bad += o.bad;
+        sixes += o.sixes; spawns += o.spawns; captured += o.captured;
+        for (int i = 0; i < LENGTH_BUCKETS; ++i) lengthHist[i] += o.lengthHist[i];
+        for (int i = 0; i < LOOP_LEN; ++i) { capturesAt[i] += o.capturesAt[i]; landingsAt[i] += o.landingsAt[i]; }
+        for (int p = 0; p < NUM_PLAYERS; ++p)
+            for (int k = 0; k <= NUM_PLAYERS; ++k) places[p][k] += o.places[p][k];
+    }
+};
+
+struct GameRef {
+    uint32_t file;
+    uint64_t offset;                            // of the ReplayGameHeader
+};
+
+static void ScanGame(const ReplayGameView& g, StatTally& t) {
+    GameState s = NewGame();
+    for (uint32_t turn = 0; turn < g.turns; ++turn) {
+        int player, dice, piece;
+        DecodeTurn(ReplayTurnByte(g, turn), player, dice, piece);
+        if (player != s.current) { t.bad++; return; }
+        if (dice == 6) t.sixes++;
+        if (piece == PASS) { t.passes++; s = ApplyMove(s, { (int8_t)PASS, (uint8_t)dice }); continue; }
+
+        const StepEntry& step = StepFor(player, s.sq[player][piece], dice);
+        if (step.dest < 0) { t.bad++; return; }
+        if (step.flags & STEP_SPAWN) t.spawns++;
+        if (IsOnLoop(step.dest)) t.landingsAt[step.dest]++;
+        int baseBefore = 0;
+        for (int op = 0; op < NUM_PLAYERS; ++op) if (op != player) baseBefore += s.baseCount[op];
+        s = ApplyMove(s, { (int8_t)piece, (uint8_t)dice });
+        if (step.flags & STEP_CAPTURES) {
+            int baseAfter = 0;
+            for (int op = 0; op < NUM_PLAYERS; ++op) if (op != player) baseAfter += s.baseCount[op];
+            t.capturesAt[step.dest] += baseAfter - baseBefore;
+            t.captured += baseAfter - baseBefore;
+        }
+    }
+    t.games++;
+    t.turns += g.turns;
+    int bucket = (int)(g.turns / LENGTH_BUCKET);
+    t.lengthHist[bucket < LENGTH_BUCKETS ? bucket : LENGTH_BUCKETS - 1]++;
+    if (!IsGameOver(s)) t.unfinished++;
+    for (int p = 0; p < NUM_PLAYERS; ++p) t.places[p][s.finishPlace[p]]++;
+}
+
+// Smallest bucket upper bound covering fraction q of the games.
+static uint64_t LengthQuantile(const StatTally& t, double q) {
+    uint64_t need = (uint64_t)(q * t.games), seen = 0;
+    for (int i = 0; i < LENGTH_BUCKETS; ++i) {
+        seen += t.lengthHist[i];
+        if (seen > need) return (uint64_t)(i + 1) * LENGTH_BUCKET;
+    }
+    return (uint64_t)LENGTH_BUCKETS * LENGTH_BUCKET;
+}
+
+static void PrintJson(const StatTally& t) {
+    printf("{\n  \"games\": %llu,\n  \"unfinished\": %llu,\n  \"corrupt\": %llu,\n",
+        (unsigned long long)t.games, (unsigned long long)t.unfinished, (unsigned long long)t.bad);
+    printf("  \"turns\": { \"mean\": %.2f, \"p50\": %llu, \"p90\": %llu, \"p99\": %llu, \"bucket\": %d, \"histogram\": [",
+        t.games ? (double)t.turns / t.games : 0.0, (unsigned long long)LengthQuantile(t, 0.5),
+        (unsigned long long)LengthQuantile(t, 0.9), (unsigned long long)LengthQuantile(t, 0.99), LENGTH_BUCKET);
+    for (int i = 0; i < LENGTH_BUCKETS; ++i) printf("%s%llu", i ? ", " : "", (unsigned long long)t.lengthHist[i]);
+    printf("] },\n");
+    printf("  \"sixes\": %llu,\n  \"spawns\": %llu,\n  \"spawnsPerSix\": %.4f,\n  \"passes\": %llu,\n  \"captures\": %llu,\n",
+        (unsigned long long)t.sixes, (unsigned long long)t.spawns, t.sixes ? (double)t.spawns / t.sixes : 0.0,
+        (unsigned long long)t.passes, (unsigned long long)t.captured);
+    printf("  \"finishOrder\": {");
+    for (int p = 0; p < NUM_PLAYERS; ++p) {
+        printf("%s\n    \"%s\": [", p ? "," : "", SEAT_NAMES[p]);
+        for (int k = 1; k <= NUM_PLAYERS; ++k) printf("%s%llu", k > 1 ? ", " : "", (unsigned long long)t.places[p][k]);
+        printf("]");
+    }
+    printf("\n  },\n  \"loopCells\": [");
+    for (int i = 0; i < LOOP_LEN; ++i)
+        printf("%s\n    { \"idx\": %d, \"r\": %d, \"c\": %d, \"safe\": %s, \"landings\": %llu, \"captures\": %llu }",
+            i ? "," : "", i, BOARD.loop[i].r, BOARD.loop[i].c, IsSafeSquare(i) ? "true" : "false",
+            (unsigned long long)t.landingsAt[i], (unsigned long long)t.capturesAt[i]);
+    printf("\n  ]\n}\n");
+}
+
+static void PrintCsv(const StatTally& t) {
+    printf("section,key,value\n");
+    printf("summary,games,%llu\nsummary,unfinished,%llu\nsummary,corrupt,%llu\n",
+        (unsigned long long)t.games, (unsigned long long)t.unfinished, (unsigned long long)t.bad);
+    printf("summary,mean_turns,%.2f\n", t.games ? (double)t.turns / t.games : 0.0);
+    printf("summary,sixes,%llu\nsummary,spawns,%llu\nsummary,spawns_per_six,%.4f\nsummary,passes,%llu\nsummary,captures,%llu\n",
+        (unsigned long long)t.sixes, (unsigned long long)t.spawns, t.sixes ? (double)t.spawns / t.sixes : 0.0,
+        (unsigned long long)t.passes, (unsigned long long)t.captured);
+    for (int i = 0; i < LENGTH_BUCKETS; ++i)
+        printf("length_lt,%d,%llu\n", (i + 1) * LENGTH_BUCKET, (unsigned long long)t.lengthHist[i]);
+    for (int p = 0; p < NUM_PLAYERS; ++p)
+        for (int k = 1; k <= NUM_PLAYERS; ++k)
+            printf("finish_%s,%d,%llu\n", SEAT_NAMES[p], k, (unsigned long long)t.places[p][k]);
+    for (int i = 0; i < LOOP_LEN; ++i) printf("captures_at,%d,%llu\n", i, (unsigned long long)t.capturesAt[i]);
+    for (int i = 0; i < LOOP_LEN; ++i)
+        if (IsSafeSquare(i)) printf("safe_landings_at,%d,%llu\n", i, (unsigned long long)t.landingsAt[i]);
+}
+
+int main(int argc, char** argv) {
+    int threads = DefaultThreadCount();
+    bool csv = false;
+    std::vector<const char*> paths;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--threads") && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--format") && i + 1 < argc) csv = !strcmp(argv[++i], "csv");
+        else if (argv[i][0] == '-') {
+            fprintf(stderr, "usage: %s [--threads T] [--format json|csv] FILE...\n", argv[0]);
+            return 2;
+        }
+        else paths.push_back(argv[i]);
+    }
+    if (paths.empty()) { fprintf(stderr, "no replay files given\n"); return 2; }
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::unique_ptr<MappedFile>> files;
+    std::vector<int> intervals;
+    std::vector<GameRef> refs;
+    size_t totalBytes = 0;
+    for (const char* path : paths) {
+        std::unique_ptr<MappedFile> f(new MappedFile());
+        int interval;
+        if (!f->Open(path, true) || !CheckReplayFileHeader(f->data, f->size, interval)) {
+            fprintf(stderr, "skipping %s: not a replay file\n", path);
+            continue;
+        }
+        uint32_t id = (uint32_t)files.size();
+        ReplayGameView g;
+        size_t at = sizeof(ReplayFileHeader), next;
+        while ((next = NextReplayGame(f->data, f->size, at, interval, g)) != 0) {
+            refs.push_back({ id, at });
+            at = next;
+        }
+        totalBytes += f->size;
+        files.push_back(std::move(f));
+        intervals.push_back(interval);
+    }
+
+    std::vector<StatTally> tallies(threads < 1 ? 1 : threads);
+    ParallelFor(refs.size(), (int)tallies.size(), 4096, [&](int w, uint64_t b, uint64_t e) {
+        for (uint64_t i = b; i < e; ++i) {
+            const MappedFile& f = *files[refs[i].file];
+            ReplayGameView g;
+            NextReplayGame(f.data, f.size, refs[i].offset, intervals[refs[i].file], g);
+            ScanGame(g, tallies[w]);
+        }
+    });
+    StatTally total;
+    for (const StatTally& t : tallies) total.Add(t);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    if (csv) PrintCsv(total); else PrintJson(total);
+    fprintf(stderr, "scanned %llu games, %.1f MB in %.3f s (%.0f MB/s)\n", (unsigned long long)total.games,
+        totalBytes / 1e6, secs, secs > 0 ? totalBytes / 1e6 / secs : 0.0);
+    return 0;
+}
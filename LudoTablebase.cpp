@@ -0,0 +1,59 @@
+#include "LudoTablebase.h"
+#include <cstring>
+
+bool RaceTablebase::Open(const char* path) {
+    if (!file.Open(path)) return false;
+    TablebaseHeader h;
+    if (file.size < sizeof(h)) return false;
+    std::memcpy(&h, file.data, sizeof(h));
+    if (std::memcmp(h.magic, "LUDORACE", 8) != 0 || h.version != TABLEBASE_VERSION
+        || h.maxPlayers < 2 || h.maxPlayers > RACE_MAX_PLAYERS) return false;
+    size_t at = sizeof(h);
+    for (int r = 2; r <= h.maxPlayers; ++r) {
+        size_t bytes = RaceTableEntries(r) * (r - 1) * sizeof(uint16_t);
+        if (at + bytes > file.size) return false;
+        section[r] = reinterpret_cast<const uint16_t*>(file.data + at);
+        at += bytes;
+    }
+    maxPlayers = h.maxPlayers;
+    return true;
+}
+
+bool RaceTablebase::Probe(const GameState& s, float place[NUM_PLAYERS]) const {
+    if (maxPlayers == 0 || IsGameOver(s)) return false;
+    int seats[NUM_PLAYERS], sets[NUM_PLAYERS], n = 0;
+    for (int k = 0; k < NUM_PLAYERS; ++k) {
+        int p = (s.current + k) % NUM_PLAYERS;
+        if (IsFinished(s, p)) { place[p] = s.finishPlace[p]; continue; }
+        if (n == maxPlayers) return false;
+        int d[NUM_PIECES];
+        for (int i = 0; i < NUM_PIECES; ++i) {
+            if (!IsInFinal(s.sq[p][i])) return false;        // still on the loop or in base
+            d[i] = HOME_STOP - s.sq[p][i];
+        }
+        seats[n] = p;
+        sets[n++] = RACE.index[RaceCode(d[0], d[1], d[2], d[3])];
+    }
+    const uint16_t* e = section[n] + RaceKey(sets, n) * (n - 1);
+    float last = n * 0.5f;
+    for (int j = 0; j < n; ++j) {
+        float share = (j < n - 1) ? e[j] / 65535.0f : last;
+        if (j < n - 1) last -= share;
+        place[seats[j]] = s.nextPlace + (n - 1) * (1.0f - share);
+    }
+    return true;
+}
+
+bool RaceTablebase::PickMove(const GameState& s, const MoveList& legal, Move& out) const {
+    if (maxPlayers == 0) return false;
+    int me = s.current;
+    float best = 1e30f;
+    for (const Move& mv : legal) {
+        GameState n = ApplyMove(s, mv);
+        float place[NUM_PLAYERS];
+        if (IsGameOver(n)) place[me] = n.finishPlace[me];
+        else if (!Probe(n, place)) return false;
+        if (place[me] < best) { best = place[me]; out = mv; }
+    }
+    return best < 1e30f;
+}
@@ -0,0 +1,102 @@
+#pragma once
+// Exact endgame tablebase for race positions.
+//
+// Once every piece still in play sits in its own home strip, nobody can be
+// captured any more and the rest of the game is a pure dice race: a player
+// is fully described by the multiset of its pieces' distances to the home
+// stop (0..5, 126 multisets), and a position by those multisets in turn
+// order. ludo_tbgen solves every such position with 2..3 players left by
+// retrograde analysis and writes the expected number of remaining
+// opponents each player finishes ahead of. The AI maps the file and reads
+// a position in O(1).
+//
+// File: TablebaseHeader, then for R = 2..maxPlayers a section of 125^R
+// entries (key = multisets in turn order, mover first, base 125) of R-1
+// uint16 shares (count / (R-1) * 65535, tuple order); the last player's
+// share is R/2 minus the others.
+#include "LudoEngine.h"
+#include "MappedFile.h"
+
+static const int RACE_SETS = 126;                  // multisets of NUM_PIECES distances 0..FINAL_LEN-1
+static const int RACE_LIVE_SETS = RACE_SETS - 1;   // set 0 = every piece home
+static const int RACE_MAX_PLAYERS = 3;             // 4 players would need 125^4 entries
+static const int RACE_CODES = FINAL_LEN * FINAL_LEN * FINAL_LEN * FINAL_LEN;
+static const int TABLEBASE_VERSION = 1;
+
+// =================== RACE SETS ==================
+struct RaceSets {
+    uint8_t d[RACE_SETS][NUM_PIECES];           // sorted distances of each multiset
+    uint8_t sum[RACE_SETS];
+    uint8_t index[RACE_CODES];                  // any distance tuple (base FINAL_LEN) -> multiset
+};
+
+constexpr int RaceCode(int a, int b, int c, int d) {
+    return ((a * FINAL_LEN + b) * FINAL_LEN + c) * FINAL_LEN + d;
+}
+
+constexpr RaceSets MakeRaceSets() {
+    RaceSets r{};
+    uint8_t bySorted[RACE_CODES] = {};
+    int n = 0;
+    for (int a = 0; a < FINAL_LEN; ++a)
+        for (int b = a; b < FINAL_LEN; ++b)
+            for (int c = b; c < FINAL_LEN; ++c)
+                for (int d = c; d < FINAL_LEN; ++d) {
+                    r.d[n][0] = (uint8_t)a; r.d[n][1] = (uint8_t)b; r.d[n][2] = (uint8_t)c; r.d[n][3] = (uint8_t)d;
+                    r.sum[n] = (uint8_t)(a + b + c + d);
+                    bySorted[RaceCode(a, b, c, d)] = (uint8_t)n++;
+                }
+    for (int code = 0; code < RACE_CODES; ++code) {
+        int v[NUM_PIECES] = { code / (FINAL_LEN * FINAL_LEN * FINAL_LEN), code / (FINAL_LEN * FINAL_LEN) % FINAL_LEN,
+                              code / FINAL_LEN % FINAL_LEN, code % FINAL_LEN };
+        for (int i = 1; i < NUM_PIECES; ++i)
+            for (int j = i; j > 0 && v[j - 1] > v[j]; --j) { int t = v[j]; v[j] = v[j - 1]; v[j - 1] = t; }
+        r.index[code] = bySorted[RaceCode(v[0], v[1], v[2], v[3])];
+    }
+    return r;
+}
+
+static constexpr RaceSets RACE = MakeRaceSets();
+
+static_assert(NUM_PIECES == 4, "race sets are enumerated for four pieces");
+static_assert(RACE.d[RACE_SETS - 1][0] == FINAL_LEN - 1, "126 multisets of four distances 0..5");
+static_assert(RACE.index[RaceCode(3, 0, 5, 1)] == RACE.index[RaceCode(0, 1, 3, 5)], "index ignores piece order");
+
+inline size_t RaceTableEntries(int players) {
+    size_t n = 1;
+    for (int i = 0; i < players; ++i) n *= RACE_LIVE_SETS;
+    return n;
+}
+
+// Key of a tuple of live multisets (1..125), mover first.
+inline size_t RaceKey(const int* sets, int players) {
+    size_t k = 0;
+    for (int i = 0; i < players; ++i) k = k * RACE_LIVE_SETS + (size_t)(sets[i] - 1);
+    return k;
+}
+
+#pragma pack(push, 1)
+struct TablebaseHeader {
+    char     magic[8];                          // "LUDORACE"
+    uint16_t version;
+    uint16_t maxPlayers;
+    uint32_t reserved;
+};
+#pragma pack(pop)
+
+// =================== LOOKUP =====================
+struct RaceTablebase {
+    MappedFile file;
+    const uint16_t* section[RACE_MAX_PLAYERS + 1] = {};
+    int maxPlayers = 0;
+
+    bool Open(const char* path);
+
+    // Expected finishing place of every seat (exact for seats already
+    // finished) if `s` is a race the table covers; false otherwise.
+    bool Probe(const GameState& s, float place[NUM_PLAYERS]) const;
+
+    // Best move by table lookup when every successor is covered (or ends
+    // the game); false if any is not.
+    bool PickMove(const GameState& s, const MoveList& legal, Move& out) const;
+};
@@ -0,0 +1,154 @@
+// ludo_tbgen: builds the race-ending tablebase (LudoTablebase.h).
+//
+//   ludo_tbgen [--players 2|3] [--out FILE]
+//
+// Retrograde analysis, smallest total distance first. A move always
+// lowers the total, so every successor is solved before the position that
+// reaches it. Only passes keep the total, and a pass just hands the same
+// pieces to the next player, so the R rotations of one tuple form a
+// closed cycle of linear equations
+//
+//   V_k = a_k + q_k * V_(k+1)      (a_k: best moves averaged over the
+//                                   dice, q_k: probability of a pass)
+//
+// which is solved exactly around the ring. Values are expected counts of
+// remaining opponents each player finishes ahead of; every player picks
+// the move that maximises its own (max-n, as in the search).
+#include "LudoTablebase.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static std::vector<float> values[RACE_MAX_PLAYERS + 1];   // [R][key * R + j], tuple order
+
+// Value vector, in tuple order, of the players in `sets` (mover first).
+static void Lookup(const int* sets, int players, float* out) {
+    if (players == 1) { out[0] = 0.0f; return; }          // alone: beats nobody
+    const float* v = &values[players][RaceKey(sets, players) * players];
+    for (int j = 0; j < players; ++j) out[j] = v[j];
+}
+
+static void Solve(int players) {
+    const int R = players;
+    size_t n = RaceTableEntries(R);
+    values[R].assign(n * R, 0.0f);
+    std::vector<uint8_t> done(n, 0);
+
+    // Bucket the keys by total distance.
+    std::vector<std::vector<uint32_t>> bySum(R * 4 * (FINAL_LEN - 1) + 1);
+    for (size_t key = 0; key < n; ++key) {
+        size_t k = key;
+        int sum = 0;
+        for (int j = 0; j < R; ++j) { sum += RACE.sum[k % RACE_LIVE_SETS + 1]; k /= RACE_LIVE_SETS; }
+        bySum[sum].push_back((uint32_t)key);
+    }
+
+    for (const auto& bucket : bySum)
+        for (uint32_t key : bucket) {
+            if (done[key]) continue;
+            int t[RACE_MAX_PLAYERS];
+            size_t k = key;
+            for (int j = R - 1; j >= 0; --j) { t[j] = (int)(k % RACE_LIVE_SETS) + 1; k /= RACE_LIVE_SETS; }
+
+            // a[r], q[r] for rotation r (mover t[r]); vectors in labels of t.
+            float a[RACE_MAX_PLAYERS][RACE_MAX_PLAYERS] = {}, q[RACE_MAX_PLAYERS] = {};
+            for (int r = 0; r < R; ++r) {
+                const uint8_t* dist = RACE.d[t[r]];
+                for (int dice = 1; dice <= 6; ++dice) {
+                    float best[RACE_MAX_PLAYERS];
+                    bool any = false;
+                    for (int i = 0; i < NUM_PIECES; ++i) {
+                        if (dist[i] < dice || (i > 0 && dist[i] == dist[i - 1])) continue;
+                        int nd[NUM_PIECES];
+                        for (int m = 0; m < NUM_PIECES; ++m) nd[m] = dist[m] - (m == i ? dice : 0);
+                        int moved = RACE.index[RaceCode(nd[0], nd[1], nd[2], nd[3])];
+
+                        float v[RACE_MAX_PLAYERS];
+                        int u[RACE_MAX_PLAYERS], un = 0;
+                        for (int j = 1; j < R; ++j) u[un++] = t[(r + j) % R];
+                        float uv[RACE_MAX_PLAYERS];
+                        if (moved == 0) {
+                            // The mover is out and beats everyone still racing.
+                            Lookup(u, un, uv);
+                            v[r] = (float)(R - 1);
+                            for (int j = 0; j < un; ++j) v[(r + 1 + j) % R] = uv[j];
+                        }
+                        else {
+                            u[un++] = moved;
+                            Lookup(u, un, uv);
+                            for (int j = 0; j < un; ++j) v[(r + 1 + j) % R] = uv[j];
+                        }
+                        if (!any || v[r] > best[r]) { std::memcpy(best, v, sizeof(float) * R); any = true; }
+                    }
+                    if (!any) q[r] += 1.0f / 6.0f;
+                    else for (int j = 0; j < R; ++j) a[r][j] += best[j] / 6.0f;
+                }
+            }
+
+            // V_0 = sum_r (prod_{j<r} q_j) a_r / (1 - prod q), then back-substitute.
+            float V[RACE_MAX_PLAYERS][RACE_MAX_PLAYERS] = {};
+            float prod = 1.0f;
+            for (int r = 0; r < R; ++r) {
+                for (int j = 0; j < R; ++j) V[0][j] += prod * a[r][j];
+                prod *= q[r];
+            }
+            for (int j = 0; j < R; ++j) V[0][j] /= (1.0f - prod);
+            for (int r = R - 1; r >= 1; --r) {
+                const float* next = V[(r + 1) % R];
+                for (int j = 0; j < R; ++j) V[r][j] = a[r][j] + q[r] * next[j];
+            }
+
+            for (int r = 0; r < R; ++r) {
+                int rot[RACE_MAX_PLAYERS];
+                for (int j = 0; j < R; ++j) rot[j] = t[(r + j) % R];
+                size_t rk = RaceKey(rot, R);
+                for (int j = 0; j < R; ++j) values[R][rk * R + j] = V[r][(r + j) % R];
+                done[rk] = 1;
+            }
+        }
+}
+
+int main(int argc, char** argv) {
+    int maxPlayers = RACE_MAX_PLAYERS;
+    const char* out = "ludo_race.tb";
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--players")) maxPlayers = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--out")) out = argv[i + 1];
+    }
+    if (maxPlayers < 2 || maxPlayers > RACE_MAX_PLAYERS) {
+        fprintf(stderr, "usage: %s [--players 2..%d] [--out FILE]\n", argv[0], RACE_MAX_PLAYERS);
+        return 2;
+    }
+
+    FILE* f = fopen(out, "wb");
+    if (!f) { fprintf(stderr, "cannot write %s\n", out); return 1; }
+    TablebaseHeader h;
+    std::memcpy(h.magic, "LUDORACE", 8);
+    h.version = TABLEBASE_VERSION;
+    h.maxPlayers = (uint16_t)maxPlayers;
+    h.reserved = 0;
+    fwrite(&h, sizeof(h), 1, f);
+
+    for (int r = 2; r <= maxPlayers; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        Solve(r);
+        size_t n = RaceTableEntries(r);
+        std::vector<uint16_t> packed(n * (r - 1));
+        for (size_t key = 0; key < n; ++key)
+            for (int j = 0; j < r - 1; ++j) {
+                float share = values[r][key * r + j] / (r - 1);
+                packed[key * (r - 1) + j] = (uint16_t)std::min(65535.0f, std::max(0.0f, share * 65535.0f + 0.5f));
+            }
+        fwrite(packed.data(), sizeof(uint16_t), packed.size(), f);
+        int all[RACE_MAX_PLAYERS] = { RACE_SETS - 1, RACE_SETS - 1, RACE_SETS - 1 };
+        printf("%d players: %zu positions in %.2f s; all pieces at the strip entrance, mover scores %.4f of %d\n", r, n,
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count(),
+            values[r][RaceKey(all, r) * r], r - 1);
+    }
+    fclose(f);
+    printf("wrote %s\n", out);
+    return 0;
+}
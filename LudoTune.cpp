@@ -0,0 +1,213 @@
+// ludo_tune: self-play tuning of the greedy AI weights on the batch engine.
+//
+//   ludo_tune [--generations G] [--population P] [--games N] [--threads T]
+//             [--seed S] [--lanes L] [--scalar]
+//   ludo_tune --verify [--games N]   batch games against PlayGame(), SIMD against scalar
+//   ludo_tune --bench [--games N]    single-thread games/s of PlayGame() and both kernels
+//
+// A genetic algorithm over the greedy (spawn, finish, capture) scores. Each
+// candidate plays N games as the hero against three seats with the default
+// weights and scores the share of opponents it beat (the defaults score
+// 0.5 on average). Every candidate of a generation plays the same game
+// indices, so they are compared on the same dice; each generation moves on
+// to fresh ones. Candidates are spread over the cores with ParallelFor, one
+// GameBatch per worker. The best weights are printed as a greedy:S:F:C
+// policy for ludo_sim and ludo --ai.
+#include "LudoBatch.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const int WEIGHT_MIN = -100, WEIGHT_MAX = 200;
+
+static double Seconds(Clock::time_point since) {
+    return std::chrono::duration<double>(Clock::now() - since).count();
+}
+
+// Share of the opponents the hero finished ahead of, over all games.
+static double HeroScore(const std::vector<BatchGameResult>& results, uint64_t first) {
+    double sum = 0;
+    for (size_t k = 0; k < results.size(); ++k) {
+        int place = results[k].finishPlace[(first + k) % NUM_PLAYERS];
+        if (place) sum += (double)(NUM_PLAYERS - place) / (NUM_PLAYERS - 1);
+    }
+    return results.empty() ? 0 : sum / results.size();
+}
+
+// =================== VERIFY =====================
+static bool SameResult(const BatchGameResult& a, const GameResult& b) {
+    if (a.plies != b.plies) return false;
+    for (int p = 0; p < NUM_PLAYERS; ++p)
+        if (a.finishPlace[p] != b.finishPlace[p]) return false;
+    return true;
+}
+
+static int Verify(uint64_t games, uint64_t seed, int lanes) {
+    const BatchMatchup matchups[] = {
+        { AiWeights(), AiWeights() },
+        { { 25, 40, 35, 3 }, AiWeights() },
+        { { -1200, 50, 20, 3 }, { 10, 50, 20, 0 } },      // below PickGreedyMove's floor; no jitter
+        { { 0, 0, 0, 1 }, { 60, -20, 5, 7 } },
+    };
+    int bad = 0;
+    for (const BatchMatchup& m : matchups) {
+        GameBatch batch(lanes);
+        std::vector<BatchGameResult> scalar, simd;
+        batch.useSimd = false;
+        batch.Play(m, seed, 0, games, scalar);
+        batch.useSimd = GameBatch::SimdCompiled();
+        batch.Play(m, seed, 0, games, simd);
+        int wrong = 0;
+        for (uint64_t g = 0; g < games; ++g) {
+            Policy seats[NUM_PLAYERS];
+            for (int p = 0; p < NUM_PLAYERS; ++p) seats[p].weights = (p == (int)(g % NUM_PLAYERS)) ? m.hero : m.field;
+            GameResult want = PlayGame(seats, seed, g);
+            wrong += !SameResult(scalar[g], want);
+            wrong += !SameResult(simd[g], want);
+        }
+        printf("hero %d/%d/%d/%d field %d/%d/%d/%d: %llu games, %d mismatches\n",
+               m.hero.spawn, m.hero.finish, m.hero.capture, m.hero.jitter,
+               m.field.spawn, m.field.finish, m.field.capture, m.field.jitter,
+               (unsigned long long)games, wrong);
+        bad += wrong;
+    }
+    printf("kernels: %s\n", GameBatch::SimdCompiled() ? "avx2 and scalar" : "scalar only (build with -mavx2)");
+    return bad ? 1 : 0;
+}
+
+// =================== BENCH ======================
+static int Bench(uint64_t games, uint64_t seed, int lanes) {
+    BatchMatchup m = { AiWeights(), AiWeights() };
+    Policy seats[NUM_PLAYERS];
+    volatile uint64_t sink = 0;
+    auto t0 = Clock::now();
+    for (uint64_t g = 0; g < games; ++g) sink = sink + PlayGame(seats, seed, g).plies;
+    double one = Seconds(t0);
+    printf("%-12s %12.0f games/s\n", "PlayGame", games / one);
+
+    GameBatch batch(lanes);
+    std::vector<BatchGameResult> out;
+    for (int simd = 0; simd <= (GameBatch::SimdCompiled() ? 1 : 0); ++simd) {
+        batch.useSimd = simd != 0;
+        t0 = Clock::now();
+        batch.Play(m, seed, 0, games, out);
+        double t = Seconds(t0);
+        printf("%-12s %12.0f games/s  (x%.2f)\n", simd ? "batch avx2" : "batch scalar", games / t, one / t);
+    }
+    return 0;
+}
+
+// =================== SEARCH =====================
+struct Candidate {
+    AiWeights w;
+    double fitness = 0;
+};
+
+struct TuneRng {
+    CounterRng rng;
+    double Uniform() { return (rng.Next() >> 11) * (1.0 / 9007199254740992.0); }
+    double Normal() {                           // Box-Muller
+        double u = Uniform(), v = Uniform();
+        return sqrt(-2.0 * log(1.0 - u)) * cos(6.283185307179586 * v);
+    }
+    int Below(int n) { return (int)rng.Below((uint32_t)n); }
+};
+
+static int Clamp(double v) { return std::min(WEIGHT_MAX, std::max(WEIGHT_MIN, (int)lround(v))); }
+
+static const Candidate& Tournament(const std::vector<Candidate>& pop, TuneRng& r) {
+    const Candidate* best = &pop[r.Below((int)pop.size())];
+    for (int k = 0; k < 2; ++k) {
+        const Candidate& c = pop[r.Below((int)pop.size())];
+        if (c.fitness > best->fitness) best = &c;
+    }
+    return *best;
+}
+
+static int Tune(int generations, int population, uint64_t games, uint64_t seed, int threads, int lanes, bool simd) {
+    TuneRng r{ CounterRng(seed, 0, STREAM_AI) };
+    std::vector<Candidate> pop(population);
+    for (int i = 1; i < population; ++i) {      // pop[0] keeps the defaults
+        pop[i].w.spawn = Clamp(r.Uniform() * 100);
+        pop[i].w.finish = Clamp(r.Uniform() * 100);
+        pop[i].w.capture = Clamp(r.Uniform() * 100);
+    }
+    std::vector<GameBatch> batches;
+    for (int t = 0; t < threads; ++t) { batches.emplace_back(lanes); batches.back().useSimd = simd; }
+    const AiWeights field;
+    const int elite = std::max(1, population / 6);
+    printf("tuning %d x %llu games per generation, %d threads, %s kernels\n", population,
+           (unsigned long long)games, threads, simd ? "avx2" : "scalar");
+
+    for (int gen = 0; gen < generations; ++gen) {
+        uint64_t first = (uint64_t)gen * games;
+        auto t0 = Clock::now();
+        ParallelFor((uint64_t)population, threads, 1, [&](int worker, uint64_t b, uint64_t e) {
+            std::vector<BatchGameResult> out;
+            for (uint64_t i = b; i < e; ++i) {
+                batches[worker].Play({ pop[i].w, field }, seed, first, games, out);
+                pop[i].fitness = HeroScore(out, first);
+            }
+        });
+        double secs = Seconds(t0);
+        std::sort(pop.begin(), pop.end(), [](const Candidate& a, const Candidate& b) { return a.fitness > b.fitness; });
+        printf("gen %3d  best greedy:%d:%d:%d  %.4f  %.0f games/s\n", gen,
+               pop[0].w.spawn, pop[0].w.finish, pop[0].w.capture, pop[0].fitness,
+               population * (double)games / secs);
+
+        // Keep the elite, breed the rest: uniform crossover, Gaussian mutation
+        // that narrows as the search goes on.
+        double sigma = 20.0 * (1.0 - 0.75 * gen / std::max(1, generations - 1));
+        std::vector<Candidate> next(pop.begin(), pop.begin() + elite);
+        while ((int)next.size() < population) {
+            const Candidate& a = Tournament(pop, r);
+            const Candidate& b = Tournament(pop, r);
+            Candidate c;
+            c.w.spawn = Clamp((r.Below(2) ? a : b).w.spawn + sigma * r.Normal());
+            c.w.finish = Clamp((r.Below(2) ? a : b).w.finish + sigma * r.Normal());
+            c.w.capture = Clamp((r.Below(2) ? a : b).w.capture + sigma * r.Normal());
+            next.push_back(c);
+        }
+        if (gen + 1 < generations) pop.swap(next);
+    }
+    printf("best: greedy:%d:%d:%d\n", pop[0].w.spawn, pop[0].w.finish, pop[0].w.capture);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    uint64_t games = 4000, seed = 1;
+    int generations = 20, population = 24, threads = DefaultThreadCount(), lanes = 1024;
+    bool verify = false, bench = false, simd = GameBatch::SimdCompiled();
+
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!strcmp(a, "--games") && v) { games = strtoull(v, nullptr, 10); ++i; }
+        else if (!strcmp(a, "--generations") && v) { generations = atoi(v); ++i; }
+        else if (!strcmp(a, "--population") && v) { population = atoi(v); ++i; }
+        else if (!strcmp(a, "--threads") && v) { threads = atoi(v); ++i; }
+        else if (!strcmp(a, "--seed") && v) { seed = strtoull(v, nullptr, 10); ++i; }
+        else if (!strcmp(a, "--lanes") && v) { lanes = atoi(v); ++i; }
+        else if (!strcmp(a, "--scalar")) simd = false;
+        else if (!strcmp(a, "--verify")) verify = true;
+        else if (!strcmp(a, "--bench")) bench = true;
+        else {
+            fprintf(stderr, "usage: %s [--generations G] [--population P] [--games N] [--threads T] [--seed S] "
+                "[--lanes L] [--scalar] [--verify] [--bench]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (threads < 1) threads = 1;
+    if (population < 2 || generations < 1 || games < 1) { fprintf(stderr, "need --population >= 2, --generations and --games >= 1\n"); return 2; }
+
+    if (verify) return Verify(games, seed, lanes);
+    if (bench) return Bench(games, seed, lanes);
+    return Tune(generations, population, games, seed, threads, lanes, simd);
+}
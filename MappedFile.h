@@ -0,0 +1,24 @@
+#pragma once
+// Read-only memory-mapped file. The view stays valid until the object dies.
+// Platform headers stay in MappedFile.cpp so this can sit next to raylib.h
+// (windows.h and raylib clash on names like Rectangle and CloseWindow).
+#include <cstddef>
+#include <cstdint>
+
+struct MappedFile {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { Close(); }
+
+    // `sequential` hints one front-to-back pass (scanners); otherwise random lookups.
+    bool Open(const char* path, bool sequential = false);
+    void Close();
+
+private:
+    void* file = nullptr;                       // Windows: file and mapping handles
+    void* mapping = nullptr;
+};
@@ -0,0 +1,77 @@
+#pragma once
+// Work-stealing ParallelFor over an index range.
+//
+// Every worker starts with an equal slice of [0, n) and eats it from the
+// front in `grain`-sized chunks. A worker that runs dry steals the back half
+// of the fullest remaining slice, so uneven chunk costs (long games, big
+// files) still keep every core busy until the very end.
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+inline int DefaultThreadCount() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n ? (int)n : 1;
+}
+
+// fn(worker, begin, end) is called with disjoint chunks covering [0, n).
+template <class Fn>
+void ParallelFor(uint64_t n, int threads, uint64_t grain, Fn&& fn) {
+    if (threads < 1) threads = 1;
+    if (grain < 1) grain = 1;
+    if ((uint64_t)threads > n) threads = (int)std::max<uint64_t>(n, 1);
+
+    struct alignas(64) Slice {
+        std::mutex m;
+        uint64_t lo = 0, hi = 0;
+    };
+    std::vector<Slice> slices(threads);
+    for (int t = 0; t < threads; ++t) {
+        slices[t].lo = n * t / threads;
+        slices[t].hi = n * (t + 1) / threads;
+    }
+
+    auto takeOwn = [&](int t, uint64_t& b, uint64_t& e) {
+        std::lock_guard<std::mutex> lk(slices[t].m);
+        if (slices[t].lo >= slices[t].hi) return false;
+        b = slices[t].lo;
+        e = std::min(slices[t].hi, b + grain);
+        slices[t].lo = e;
+        return true;
+    };
+    auto steal = [&](int t) {
+        for (;;) {
+            int victim = -1;
+            uint64_t most = 0;
+            for (int v = 0; v < threads; ++v) {
+                if (v == t) continue;
+                std::lock_guard<std::mutex> lk(slices[v].m);
+                uint64_t left = slices[v].hi - slices[v].lo;
+                if (left > most) { most = left; victim = v; }
+            }
+            if (victim < 0) return false;
+            std::scoped_lock lk(slices[victim].m, slices[t].m);
+            uint64_t left = slices[victim].hi - slices[victim].lo;
+            if (left == 0) continue;                    // raced with the owner; look again
+            uint64_t mid = slices[victim].hi - (left + 1) / 2;
+            slices[t].lo = mid;
+            slices[t].hi = slices[victim].hi;
+            slices[victim].hi = mid;
+            return true;
+        }
+    };
+    auto work = [&](int t) {
+        uint64_t b, e;
+        for (;;) {
+            while (takeOwn(t, b, e)) fn(t, b, e);
+            if (!steal(t)) return;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) pool.emplace_back(work, t);
+    work(0);
+    for (auto& th : pool) th.join();
+}